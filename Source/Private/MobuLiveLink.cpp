@@ -2,6 +2,7 @@
 
 #include "RequiredProgramMainCPPInclude.h"
 #include "MobuLiveLinkCommon.h"
+#include "MobuLiveLinkUtilities.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogMoBuPlugin, Log, All);
 
@@ -34,6 +35,15 @@ bool FBLibrary::LibInit()
 	IPluginManager::Get().LoadModulesForEnabledPlugins(ELoadingPhase::PreDefault);
 	IPluginManager::Get().LoadModulesForEnabledPlugins(ELoadingPhase::Default);
 	IPluginManager::Get().LoadModulesForEnabledPlugins(ELoadingPhase::PostDefault);
+
+#if !UE_BUILD_SHIPPING
+	// The vectorized transform conversion streams every bone, check it once per session against the scalar and baseline conversions
+	if (!MobuUtilities::CheckTransformConversions())
+	{
+		FBTrace("MobuLiveLink Transform conversion check failed\n");
+		ensureMsgf(false, TEXT("MobuLiveLink transform conversions disagree with the baseline MotionBuilder to Unreal conversion"));
+	}
+#endif
 	
 	FBTrace("MobuLiveLink Library Initialized\n");
 	return true;
@@ -12,6 +12,11 @@
 //--- Allow ticking of the engine
 #include "Containers/Ticker.h"
 
+//--- Parallel frame building
+THIRD_PARTY_INCLUDES_START
+#include "tbb/parallel_for.h"
+THIRD_PARTY_INCLUDES_END
+
 //--- UDP Network configuration
 #include "Features/IModularFeatures.h"
 #include "INetworkMessagingExtension.h"
@@ -37,6 +42,43 @@ FString GetDeviceIconPath()
 
 #include "Windows/HideWindowsPlatformTypes.h"
 
+// Python entry point, the spec is consumed and never stored in the property
+static void SetBatchAddSubjects(HIObject Object, const char* Value)
+{
+	FMobuLiveLink* Device = FBCast<FMobuLiveLink>(Object);
+	if (Device && Value)
+	{
+		FString Report;
+		Device->AddStreamObjectsFromSpec(CharToFString(Value), Report);
+		Device->BatchReport = TCHAR_TO_UTF8(*Report);
+	}
+}
+
+// Drop an index entry only if it still points at the given stream object
+template<typename KeyType>
+void RemoveIndexEntry(TMap<KeyType, int32>& Index, const KeyType& Key, int32 UID)
+{
+	const int32* IndexedUID = Index.Find(Key);
+	if (IndexedUID && *IndexedUID == UID)
+	{
+		Index.Remove(Key);
+	}
+}
+
+// Time without playback, scrubbing or scene edits before the idle rate applies
+static const double SceneIdleDelaySeconds = 0.5;
+
+// Device period while sampling on the reference time, well below a frame of any house sync rate
+static const double ReferenceSamplePollSeconds = 0.001;
+
+// Absolute subject rates are checked on device updates, an update this close to a subject's deadline samples it
+static const double RateClassToleranceSeconds = 0.001;
+
+#if !UE_BUILD_SHIPPING
+// Updates with the same subjects before one is counted, long enough for every static bone check to have demoted what moved
+static const int32 AllocationCheckSettledUpdates = 300;
+#endif
+
 //--- Device strings
 #define MOBULIVELINK__CLASS	MOBULIVELINK__CLASSNAME
 #define MOBULIVELINK__NAME	MOBULIVELINK__CLASSSTR
@@ -57,11 +99,12 @@ FBRegisterDevice		(	MOBULIVELINK__NAME,
 bool FMobuLiveLink::FBCreate()
 {
 	// Set sampling rate to Before Render
-	CurrentSampleRate = SampleOptions.Last().Value;
+	CurrentSampleRate = FFrameRate(-1, 1);
 	UpdateSampleRate();
 
 	StartLiveLink();
 	FBSystem().Scene->OnChange.Add(this, (FBCallback)&FMobuLiveLink::EventSceneChange);
+	FBSystem().OnUIIdle.Add(this, (FBCallback)&FMobuLiveLink::EventUIIdle);
 
 	TSharedPtr<IStreamObject> EditorCamera = MakeShared<FEditorActiveCameraStreamObject>();
 	EditorCameraObject = EditorCamera;
@@ -70,6 +113,11 @@ bool FMobuLiveLink::FBCreate()
 	LastEvaluationTime = FPlatformTime::Seconds();
 	TimecodeMode = ETimecodeMode::TimecodeMode_Local;
 
+	FBPropertyPublish(this, BatchAddSubjects, "BatchAddSubjects", nullptr, SetBatchAddSubjects);
+	FBPropertyPublish(this, BatchReport, "BatchReport", nullptr, nullptr);
+	BatchAddSubjects.ModifyPropertyFlag(kFBPropertyFlagNotSavable, true);
+	BatchReport.ModifyPropertyFlag(kFBPropertyFlagNotSavable, true);
+
 	FBTrace("MobuLiveLink FBCreate\n");
 	return true;
 }
@@ -81,21 +129,36 @@ bool FMobuLiveLink::FBCreate()
 void FMobuLiveLink::FBDestroy()
 {
 	FBSystem().Scene->OnChange.Remove(this, (FBCallback)&FMobuLiveLink::EventSceneChange);
+	FBSystem().OnUIIdle.Remove(this, (FBCallback)&FMobuLiveLink::EventUIIdle);
 	if (bShouldUpdateInRenderCallback)
 	{
 		FBEvaluateManager::TheOne().OnRenderingPipelineEvent.Remove(this, (FBCallback)&FMobuLiveLink::EventRenderUpdate);
 		bShouldUpdateInRenderCallback = false;
 	}
 
+	if (bShouldUpdateAfterDAG)
+	{
+		FBEvaluateManager::TheOne().OnEvaluationPipelineEvent.Remove(this, (FBCallback)&FMobuLiveLink::EventEvaluationUpdate);
+		bShouldUpdateAfterDAG = false;
+	}
+
+	StreamUpdateLock.Lock();
+
 	TSharedPtr<IStreamObject> EditorCameraObjectPin = EditorCameraObject.Pin();
 	if (EditorCameraObjectPin.IsValid())
 	{
-		LiveLinkProvider->RemoveSubject(EditorCameraObjectPin->GetSubjectName());
+		SendRemoveSubject(EditorCameraObjectPin->GetSubjectName());
 		FBTrace("Destroying Editor Camera\n");
 	}
 
-	StreamObjects.Empty();
+	StreamObjectRegistry.Empty();
+	ModelToUID.Empty();
+	RootNameToUID.Empty();
+	SubjectNameToUID.Empty();
+	FlushPendingSubjectRemovals();
 	StopLiveLink();
+
+	StreamUpdateLock.Unlock();
 	FBTrace("MobuLiveLink FBDestroy\n");
 }
 
@@ -106,7 +169,27 @@ void FMobuLiveLink::UpdateSampleRate()
 {
 	FBTime	lPeriod;
 
-	if (CurrentSampleRate == FFrameRate(-1, 1))
+	// After DAG streams from the render callback like Before Render, and measures how long each frame waited there since its DAG evaluation
+	const bool bAfterDAG = CurrentSampleRate == FFrameRate(-3, 1);
+	if (bAfterDAG != bShouldUpdateAfterDAG)
+	{
+		if (bAfterDAG)
+		{
+			AfterDAGLeadSumMs = 0.0;
+			AfterDAGLeadMaxMs = 0.0;
+			AfterDAGLeadCount = 0;
+			LastAfterDAGEntryTime = 0.0;
+			FBEvaluateManager::TheOne().OnEvaluationPipelineEvent.Add(this, (FBCallback)&FMobuLiveLink::EventEvaluationUpdate);
+		}
+		else
+		{
+			FBEvaluateManager::TheOne().OnEvaluationPipelineEvent.Remove(this, (FBCallback)&FMobuLiveLink::EventEvaluationUpdate);
+			TraceAfterDAGLead();
+		}
+		bShouldUpdateAfterDAG = bAfterDAG;
+	}
+
+	if (CurrentSampleRate == FFrameRate(-1, 1) || bAfterDAG)
 	{
 		if (!bShouldUpdateInRenderCallback)
 		{
@@ -125,10 +208,21 @@ void FMobuLiveLink::UpdateSampleRate()
 			bShouldUpdateInRenderCallback = false;
 		}
 
-		lPeriod.SetSecondDouble((double)CurrentSampleRate.Denominator / (double)CurrentSampleRate.Numerator);
+		if (CurrentSampleRate == FFrameRate(-2, 1))
+		{
+			// Reference Time, polled and only streamed on the first poll past each reference frame boundary
+			lPeriod.SetSecondDouble(ReferenceSamplePollSeconds);
+		}
+		else
+		{
+			lPeriod.SetSecondDouble((double)CurrentSampleRate.Denominator / (double)CurrentSampleRate.Numerator);
+		}
 	}
+	bHasReferenceFrame = false;
 	FBTrace("Setting Sample Rate: %f\n", lPeriod.GetSecondDouble());
 	SamplingPeriod = lPeriod;
+
+	UpdateSenderPacing();
 }
 
 
@@ -179,6 +273,10 @@ bool FMobuLiveLink::Start()
 	lProgress.Caption = "Setting up device";
 	lProgress.Text = "Setting sampling rate";
 
+	// Transport settings may have changed while we were offline, going online also aligns the system timecode again
+	TimecodeService.Invalidate();
+	TimecodeService.Resync();
+
 	SetDeviceInformation("Status: Online");
 	return true;
 }
@@ -220,9 +318,9 @@ bool FMobuLiveLink::Reset()
  ************************************************/
 bool FMobuLiveLink::DeviceEvaluationNotify(kTransportMode pMode, FBEvaluateInfo* pEvaluateInfo)
 {
-	if (!bShouldUpdateInRenderCallback)
+	if (!bShouldUpdateInRenderCallback && IsReferenceFrameDue() && IsStreamUpdateDue(false))
 	{
-		UpdateStream();
+		UpdateStream(pEvaluateInfo);
 	}
 	return true;
 }
@@ -230,36 +328,277 @@ bool FMobuLiveLink::DeviceEvaluationNotify(kTransportMode pMode, FBEvaluateInfo*
 void FMobuLiveLink::EventRenderUpdate(HISender Sender, HKEvent Event)
 {
 	FBGlobalEvalCallbackTiming EventTiming = ((FBEventEvalGlobalCallback)Event).GetTiming();
-	if (EventTiming == FBSDKNamespace::kFBGlobalEvalCallbackBeforeRender && this->Online)
+	if (EventTiming != FBSDKNamespace::kFBGlobalEvalCallbackBeforeRender || !this->Online)
+	{
+		return;
+	}
+
+	// Only a frame whose DAG evaluation was seen is measured, the pipeline may already be evaluating the next one
+	const double EntryTime = bShouldUpdateAfterDAG ? LastAfterDAGEntryTime.exchange(0.0) : 0.0;
+	if (EntryTime > 0.0 && LastAfterDAGLocalTime.load() == FBSystem::TheOne().LocalTime.Get())
 	{
-		UpdateStream();
+		const double LeadMs = (FPlatformTime::Seconds() - EntryTime) * 1000.0;
+		AfterDAGLeadSumMs += LeadMs;
+		AfterDAGLeadMaxMs = FMath::Max(AfterDAGLeadMaxMs, LeadMs);
+		++AfterDAGLeadCount;
+	}
+
+	if (IsStreamUpdateDue(true))
+	{
+		// Evaluation is complete before render, the models' current values are read directly
+		UpdateStream(nullptr);
 
 		// Count samples here since we aren't doing it in DeviceIONotify for render callback usage
 		AckOneSampleReceived();
 	}
 }
 
-void FMobuLiveLink::UpdateStream()
+// Runs on the evaluation thread, which hands us no evaluation context to read the scene through.
+// It only records that the DAG of the frame is done, the frame is read and streamed by the render callback
+void FMobuLiveLink::EventEvaluationUpdate(HISender Sender, HKEvent Event)
+{
+	FBGlobalEvalCallbackTiming EventTiming = ((FBEventEvalGlobalCallback)Event).GetTiming();
+	if (EventTiming == FBSDKNamespace::kFBGlobalEvalCallbackAfterDAG)
+	{
+		// Local time first, the render callback only reads it once the entry time is set
+		LastAfterDAGLocalTime = FBSystem::TheOne().LocalTime.Get();
+		LastAfterDAGEntryTime = FPlatformTime::Seconds();
+	}
+}
+
+void FMobuLiveLink::TraceAfterDAGLead() const
+{
+	if (AfterDAGLeadCount > 0)
+	{
+		FBTrace("MobuLiveLink frames were streamed %.3f ms after their DAG evaluation on average, %.3f ms at most, over %lld frames\n",
+			AfterDAGLeadSumMs / (double)AfterDAGLeadCount, AfterDAGLeadMaxMs, AfterDAGLeadCount);
+	}
+}
+
+void FMobuLiveLink::UpdateStream(FBEvaluateInfo* EvaluateInfo)
 {
-	mCleanUpLock.Lock();
+	// Only held elsewhere while the provider or the sender is replaced, or by the other callback streaming.
+	// The update is skipped rather than waiting, the next one picks up where it left
+	if (!StreamUpdateLock.TryLock())
+	{
+		return;
+	}
 
 	TickCoreTicker();
 
+	// The core ticker runs the message bus, only what follows is ours to keep allocation free
+	bool bIsCountingAllocations = false;
+#if !UE_BUILD_SHIPPING
+	TOptional<MobuUtilities::FScopedAllocationCounter> AllocationCounter;
+	if (SettledStreamUpdateCount == AllocationCheckSettledUpdates)
+	{
+		AllocationCounter.Emplace();
+		bIsCountingAllocations = true;
+	}
+#endif
+
 	FLiveLinkWorldTime WorldTime;
-	FQualifiedFrameTime QualifiedFrameTime = MobuUtilities::GetSceneTimecode(GetTimecodeMode());
+	FQualifiedFrameTime QualifiedFrameTime = TimecodeService.GetTimecode(GetTimecodeMode());
 
 
-	if (IsDirty())
+	// Clear the flag before taking the snapshot, writers publish before they set it
+	const bool bRefreshDue = IsRefreshDue();
+	const bool bHasDirtyStreamObjects = bRefreshDue && bIsDirty.exchange(false);
+
+	// Edits published after this point are picked up next frame
+	const FMobuStreamObjectRegistry::FSnapshot& Snapshot = StreamObjectRegistry.AcquireRead();
+
+	FlushPendingSubjectRemovals();
+	if (bHasDirtyStreamObjects)
 	{
-		UpdateStreamObjects();
+		RefreshStreamObjects(Snapshot.StreamObjects);
 	}
-	for (TPair<int32, TSharedPtr<IStreamObject>>& MapPair : StreamObjects)
+
+	// Jobs are keyed by UID and reused in place, every frame lands in the struct its subject used last time
+	// Subjects sharing a rate are phased by their UID, so their cost is spread across updates and adding, removing
+	// or skipping another subject never moves their cadence
+	++StreamUpdateCount;
+	const double ScheduleTime = FPlatformTime::Seconds();
+	for (const TPair<int32, TSharedPtr<IStreamObject>>& MapPair : Snapshot.StreamObjects)
 	{
-		const TSharedPtr<IStreamObject>& StreamObject = MapPair.Value;
-		StreamObject->UpdateSubjectFrame(LiveLinkProvider, WorldTime, QualifiedFrameTime);
+		FFrameBuildJob& Job = FrameBuildJobs.FindOrAdd(MapPair.Key);
+		if (Job.StreamObject != MapPair.Value)
+		{
+			Job.StreamObject = MapPair.Value;
+			Job.bHasSentFrame = false;
+			Job.NextSampleTime = -1.0;
+		}
+		Job.bHasFrame = false;
+		Job.bIsDue = false;
+
+		// While a refresh is held back, an invalidated hierarchy may reference models that no longer exist
+		if ((!bRefreshDue && MapPair.Value->IsDirty()) || !MapPair.Value->IsValid())
+		{
+			continue;
+		}
+
+		if (MapPair.Value->GetActiveStatus())
+		{
+			const FStreamRateClass RateClass = MapPair.Value->GetRateClass();
+			Job.bIsDue = true;
+
+			// Hashed so the editor camera's negative UID gets a phase like any other
+			const uint32 Phase = GetTypeHash(MapPair.Key);
+			if (RateClass.Divisor > 1)
+			{
+				Job.bIsDue = (StreamUpdateCount + Phase) % RateClass.Divisor == 0;
+			}
+			if (RateClass.MaxRate > 0)
+			{
+				const double Interval = 1.0 / RateClass.MaxRate;
+				if (Job.NextSampleTime < 0.0)
+				{
+					// Golden ratio steps keep the first deadlines apart however many subjects share the rate
+					Job.NextSampleTime = ScheduleTime + Interval * FMath::Frac(Phase * 0.6180339887);
+				}
+
+				if (Job.bIsDue && ScheduleTime >= Job.NextSampleTime - RateClassToleranceSeconds)
+				{
+					// Deadlines advance by whole intervals so the rate holds whatever the device period
+					Job.NextSampleTime += Interval;
+					if (Job.NextSampleTime <= ScheduleTime)
+					{
+						Job.NextSampleTime = ScheduleTime + Interval;
+					}
+				}
+				else
+				{
+					Job.bIsDue = false;
+				}
+			}
+		}
+	}
+
+	// Jobs of removed stream objects are only looked for when the set changed
+	if (Snapshot.Version != FrameBuildJobsVersion)
+	{
+		for (TMap<int32, FFrameBuildJob>::TIterator JobIt = FrameBuildJobs.CreateIterator(); JobIt; ++JobIt)
+		{
+			if (!Snapshot.StreamObjects.Contains(JobIt.Key()))
+			{
+				JobIt.RemoveCurrent();
+			}
+		}
+		FrameBuildJobsVersion = Snapshot.Version;
+	}
+
+	DueFrameBuildJobs.Reset();
+	for (TPair<int32, FFrameBuildJob>& JobPair : FrameBuildJobs)
+	{
+		if (JobPair.Value.bIsDue)
+		{
+			DueFrameBuildJobs.Add(&JobPair.Value);
+		}
+	}
+
+	const bool bDetectChanges = IdleKeepAliveMs > 0;
+	auto BuildFrame = [&WorldTime, &QualifiedFrameTime, EvaluateInfo, bDetectChanges](FFrameBuildJob& Job)
+	{
+		Job.bHasFrame = Job.StreamObject->UpdateSubjectFrame(WorldTime, QualifiedFrameTime, EvaluateInfo, Job.FrameData);
+		if (Job.bHasFrame && bDetectChanges)
+		{
+			Job.FrameHash = MobuUtilities::HashFrameData(Job.FrameData);
+		}
+	};
+
+	// Parallel phase: every object samples and converts its own hierarchy.
+	// Only the device evaluation hands us an evaluation context, the render and DAG callbacks read the shared scene state and stay serial.
+	// The allocation counter only sees this thread, the counted update builds every frame here
+	if (bParallelFrameBuild && EvaluateInfo != nullptr && DueFrameBuildJobs.Num() > 1 && !bIsCountingAllocations)
+	{
+		tbb::parallel_for(0, DueFrameBuildJobs.Num(), [this, &BuildFrame](int32 JobIndex)
+		{
+			FFrameBuildJob& Job = *DueFrameBuildJobs[JobIndex];
+			if (Job.StreamObject->CanUpdateInParallel())
+			{
+				BuildFrame(Job);
+			}
+		});
+
+		for (FFrameBuildJob* Job : DueFrameBuildJobs)
+		{
+			if (!Job->StreamObject->CanUpdateInParallel())
+			{
+				BuildFrame(*Job);
+			}
+		}
+	}
+	else
+	{
+		for (FFrameBuildJob* Job : DueFrameBuildJobs)
+		{
+			BuildFrame(*Job);
+		}
+	}
+
+	// Serial phase: the provider is not thread safe, hand the results over in a stable order
+	const double SendTime = FPlatformTime::Seconds();
+	for (FFrameBuildJob* DueJob : DueFrameBuildJobs)
+	{
+		FFrameBuildJob& Job = *DueJob;
+		if (!Job.bHasFrame)
+		{
+			continue;
+		}
+
+		const FName SubjectName = Job.StreamObject->GetSubjectName();
+		if (bDetectChanges)
+		{
+			// A subject that did not move is only resent as a keep alive, or after UE rebuilt it from its own new static data
+			const FSentStaticData* Sent = SentStaticData.Find(SubjectName);
+			const uint64 SubjectStaticDataGeneration = Sent ? Sent->Generation : 0;
+			const bool bUnchanged = Job.bHasSentFrame && Job.FrameHash == Job.SentFrameHash && Job.SentStaticDataGeneration == SubjectStaticDataGeneration;
+			if (bUnchanged && (SendTime - Job.SentFrameTime) * 1000.0 < IdleKeepAliveMs)
+			{
+				continue;
+			}
+
+			Job.SentFrameHash = Job.FrameHash;
+			Job.SentFrameTime = SendTime;
+			Job.SentStaticDataGeneration = SubjectStaticDataGeneration;
+			Job.bHasSentFrame = true;
+		}
+
+		SendSubjectFrameData(SubjectName, Job.FrameData);
 	}
 
-	mCleanUpLock.Unlock();
+	if (Sender.IsValid())
+	{
+		Sender->Wake();
+	}
+
+#if !UE_BUILD_SHIPPING
+	if (Snapshot.Version != AllocationCheckVersion || bHasDirtyStreamObjects)
+	{
+		AllocationCheckVersion = Snapshot.Version;
+		SettledStreamUpdateCount = 0;
+	}
+	else if (SettledStreamUpdateCount <= AllocationCheckSettledUpdates)
+	{
+		++SettledStreamUpdateCount;
+	}
+
+	if (AllocationCounter.IsSet())
+	{
+		const int32 AllocationCount = AllocationCounter->GetCount();
+		AllocationCounter.Reset();
+
+		// A refresh or a subject edit during the counted update is expected to allocate, the next settled update is counted instead
+		if (SettledStreamUpdateCount > AllocationCheckSettledUpdates && AllocationCount > 0)
+		{
+			FBTrace("MobuLiveLink Steady state stream update made %d allocations over %d subjects\n", AllocationCount, DueFrameBuildJobs.Num());
+			ensureMsgf(false, TEXT("MobuLiveLink steady state stream update made %d allocations"), AllocationCount);
+		}
+	}
+#endif
+
+	StreamObjectRegistry.ReleaseRead();
+	StreamUpdateLock.Unlock();
 }
 
 
@@ -294,24 +633,114 @@ void FMobuLiveLink::DeviceIONotify(kDeviceIOs pAction,FBDeviceNotifyInfo &pDevic
 	}
 }
 
-int32 FMobuLiveLink::GetCurrentSampleRateIndex()
+bool FMobuLiveLink::IsStreamUpdateDue(bool bRenderCallback)
+{
+	const double CurrentTime = FPlatformTime::Seconds();
+
+	// Viewport redraws are not paced, an idle viewport can redraw hundreds of times per second.
+	// The device evaluation already runs at the sample rate and is left alone
+	double MinInterval = 0.0;
+	if (bRenderCallback && MaxRenderSendRate > 0)
+	{
+		MinInterval = 1.0 / MaxRenderSendRate;
+	}
+	if (bRenderCallback && IdleSendRate > 0 && IsSceneIdle(CurrentTime))
+	{
+		MinInterval = FMath::Max(MinInterval, 1.0 / IdleSendRate);
+	}
+
+	if (CurrentTime - LastStreamUpdateTime.load() < MinInterval)
+	{
+		return false;
+	}
+	LastStreamUpdateTime = CurrentTime;
+	return true;
+}
+
+bool FMobuLiveLink::IsReferenceFrameDue()
+{
+	if (CurrentSampleRate != FFrameRate(-2, 1))
+	{
+		return true;
+	}
+
+	// Every seat locked to the same house sync crosses the boundaries together. Without a source, the transport rate on the system clock is used
+	FFrameNumber ReferenceFrame;
+	TimecodeService.GetReferenceFrame(ReferenceFrame);
+	if (bHasReferenceFrame && ReferenceFrame == LastReferenceFrame)
+	{
+		return false;
+	}
+
+	LastReferenceFrame = ReferenceFrame;
+	bHasReferenceFrame = true;
+	return true;
+}
+
+bool FMobuLiveLink::IsSceneIdle(double CurrentTime)
+{
+	// Playback, scrubbing and manipulation are picked up on the very next update.
+	// Read through the SDK singletons, nothing is constructed per update
+	FBPlayerControl& PlayerControl = FBPlayerControl::TheOne();
+	const kLongLong LocalTime = FBSystem::TheOne().LocalTime.Get();
+	const bool bTimeMoved = LocalTime != LastIdleCheckLocalTime.exchange(LocalTime);
+
+	if (bTimeMoved || PlayerControl.IsPlaying || PlayerControl.IsRecording || OpenSceneTransactions > 0)
+	{
+		LastSceneActivityTime = CurrentTime;
+		return false;
+	}
+	return CurrentTime - LastSceneActivityTime >= SceneIdleDelaySeconds;
+}
+
+void FMobuLiveLink::SetMaxRenderSendRate(int32 InRate)
+{
+	MaxRenderSendRate = FMath::Max(InRate, 0);
+}
+
+void FMobuLiveLink::SetIdleSendRate(int32 InRate)
+{
+	IdleSendRate = FMath::Max(InRate, 0);
+}
+
+int32 FMobuLiveLink::GetCurrentSampleRateIndex() const
 {
 	int32 CurrentSampleIdx = 0;
 	for (int SampleIdx = 0; SampleIdx < SampleOptions.Num(); ++SampleIdx)
 	{
 		const FFrameRate& TestSampleRate = SampleOptions[SampleIdx].Value;
 		if (CurrentSampleRate == TestSampleRate)
+		{
+			return SampleIdx;
+		}
+		else if (TestSampleRate == FFrameRate(-4, 1) && CurrentSampleRate == CustomSampleRate)
 		{
 			CurrentSampleIdx = SampleIdx;
-			break;
 		}
 	}
 	return CurrentSampleIdx;
 }
 
+void FMobuLiveLink::SetCustomSampleRate(FFrameRate InRate)
+{
+	if (InRate.Numerator <= 0 || InRate.Denominator <= 0)
+	{
+		return;
+	}
+
+	const bool bIsCustomCurrent = SampleOptions[GetCurrentSampleRateIndex()].Value == FFrameRate(-4, 1);
+	CustomSampleRate = InRate;
+	if (bIsCustomCurrent && CurrentSampleRate != CustomSampleRate)
+	{
+		CurrentSampleRate = CustomSampleRate;
+		UpdateSampleRate();
+	}
+}
+
 //--- FBX load/save tags
 #define MOBULIVELINK_FBX_DATA_V4 "MobuLiveLinkFBXDataV4"
-#define MOBULIVELINK_FBX_DATA "MobuLiveLinkFBXDataV5"
+#define MOBULIVELINK_FBX_DATA_V5 "MobuLiveLinkFBXDataV5"
+#define MOBULIVELINK_FBX_DATA "MobuLiveLinkFBXDataV6"
 
 /************************************************
 * Save Format:
@@ -328,6 +757,22 @@ int32 FMobuLiveLink::GetCurrentSampleRateIndex()
 *      Int Animatable status
 *    Int Number of Static Endpoints
 *      Str Static Endpoint
+*    Int Number of object, in the order of the object records above
+*      Int Rate divisor
+*      Int Max rate
+*    Int Custom sample rate numerator
+*    Int Custom sample rate denominator
+*    Int Sender thread
+*    Int Parallel frame build
+*    Int Refresh coalescing window in ms
+*    Int Transaction aware refresh
+*    Int Paced sending
+*    Int Skeletal sampling mode
+*    Int Parallel bone threshold
+*    Int Cache static bones
+*    Int Idle keep alive in ms
+*    Int Idle send rate
+*    Int Max render send rate
 ************************************************/
 
 /************************************************
@@ -353,8 +798,9 @@ bool FMobuLiveLink::FbxStore(FBFbxObject* pFbxObject, kFbxObjectStore pStoreWhat
 			pFbxObject->FieldWriteI(GetCurrentSampleRateIndex());
 
 			// NumberOfObjects
+			const TMap<int32, TSharedPtr<IStreamObject>>& StreamObjects = GetStreamObjects();
 			int NumberOfObjects = 0;
-			for (TPair<int32, TSharedPtr<IStreamObject>>& MapPair : StreamObjects)
+			for (const TPair<int32, TSharedPtr<IStreamObject>>& MapPair : StreamObjects)
 			{
 				const FString StreamObjectRootName = MapPair.Value->GetRootName();
 				if (StreamObjectRootName.Len() > 0)
@@ -364,7 +810,7 @@ bool FMobuLiveLink::FbxStore(FBFbxObject* pFbxObject, kFbxObjectStore pStoreWhat
 			}
 			pFbxObject->FieldWriteI(NumberOfObjects);
 
-			for (TPair<int32, TSharedPtr<IStreamObject>>& MapPair : StreamObjects)
+			for (const TPair<int32, TSharedPtr<IStreamObject>>& MapPair : StreamObjects)
 			{
 				const FString StreamObjectRootName = MapPair.Value->GetRootName();
 				if (StreamObjectRootName.Len() > 0)
@@ -392,6 +838,41 @@ bool FMobuLiveLink::FbxStore(FBFbxObject* pFbxObject, kFbxObjectStore pStoreWhat
 				pFbxObject->FieldWriteC(FStringToChar(Endpoint));
 			}
 
+			// Rate classes, written in the same order as the object records so they are matched back by position
+			pFbxObject->FieldWriteI(NumberOfObjects);
+			for (const TPair<int32, TSharedPtr<IStreamObject>>& MapPair : StreamObjects)
+			{
+				const FString StreamObjectRootName = MapPair.Value->GetRootName();
+				if (StreamObjectRootName.Len() > 0)
+				{
+					const FStreamRateClass RateClass = MapPair.Value->GetRateClass();
+
+					pFbxObject->FieldWriteI(RateClass.Divisor);
+					pFbxObject->FieldWriteI(RateClass.MaxRate);
+				}
+			}
+
+			// Custom sample rate, the option itself is the sample rate index above
+			pFbxObject->FieldWriteI(CustomSampleRate.Numerator);
+			pFbxObject->FieldWriteI(CustomSampleRate.Denominator);
+
+			// Sending and refresh options
+			pFbxObject->FieldWriteI(IsSenderThreadEnabled());
+			pFbxObject->FieldWriteI(IsParallelFrameBuildEnabled());
+			pFbxObject->FieldWriteI(GetRefreshCoalesceWindowMs());
+			pFbxObject->FieldWriteI(IsTransactionAwareRefreshEnabled());
+			pFbxObject->FieldWriteI(IsPacedSendingEnabled());
+
+			// Skeletal sampling
+			pFbxObject->FieldWriteI((int32)SkeletalSamplingSettings.Mode);
+			pFbxObject->FieldWriteI(SkeletalSamplingSettings.ParallelBoneThreshold);
+			pFbxObject->FieldWriteI(SkeletalSamplingSettings.bCacheStaticBones);
+
+			// Idle and render rates
+			pFbxObject->FieldWriteI(GetIdleKeepAliveMs());
+			pFbxObject->FieldWriteI(GetIdleSendRate());
+			pFbxObject->FieldWriteI(GetMaxRenderSendRate());
+
 			pFbxObject->FieldWriteEnd();
 			FBTrace("FbxStore finished\n");
 		}
@@ -416,20 +897,61 @@ bool FMobuLiveLink::FbxRetrieve(FBFbxObject* FbxObject, kFbxObjectStore StoreWha
 			SetRefreshUI(true);
 			FBTrace("FbxRetrieve finished\n");
 		}
-		else if (FbxObject->FieldReadBegin(MOBULIVELINK_FBX_DATA))
+		else if (FbxObject->FieldReadBegin(MOBULIVELINK_FBX_DATA_V5))
 		{
 			FBTrace("FbxRetrieve started\n");
-			FbxRetrieveV4(FbxObject, StoreWhat);
+			FbxRetrieveV5(FbxObject, StoreWhat);
 
-			// Unicast endpoint
-			SetUnicastEndpoint(CharToFString(FbxObject->FieldReadC()));
+			FbxObject->FieldReadEnd();
 
-			// Static endpoints
-			const int StaticEndpointNum = FbxObject->FieldReadI();
-			for (int i = 0; i < StaticEndpointNum; ++i)
+			SetRefreshUI(true);
+			FBTrace("FbxRetrieve finished\n");
+		}
+		else if (FbxObject->FieldReadBegin(MOBULIVELINK_FBX_DATA))
+		{
+			FBTrace("FbxRetrieve started\n");
+			TArray<StreamObjectPtr> RecordObjects;
+			FbxRetrieveV5(FbxObject, StoreWhat, &RecordObjects);
+
+			// Rate classes, one per object record. Subject names may repeat, the record position does not
+			const int32 NumberOfRateClasses = FbxObject->FieldReadI();
+			for (int32 i = 0; i < NumberOfRateClasses; ++i)
 			{
-				AddStaticEndpoint(CharToFString(FbxObject->FieldReadC()));
+				FStreamRateClass RateClass;
+				RateClass.Divisor = FbxObject->FieldReadI();
+				RateClass.MaxRate = FbxObject->FieldReadI();
+
+				// Objects whose root was not found in the scene were skipped by the V4 data
+				if (RecordObjects.IsValidIndex(i) && RecordObjects[i].IsValid())
+				{
+					RecordObjects[i]->UpdateRateClass(RateClass);
+				}
 			}
+
+			// Custom sample rate
+			const int32 CustomNumerator = FbxObject->FieldReadI();
+			const int32 CustomDenominator = FbxObject->FieldReadI();
+			SetCustomSampleRate(FFrameRate(CustomNumerator, CustomDenominator));
+
+			// Sending and refresh options, the sender thread first since paced sending runs on it
+			SetSenderThreadEnabled(FbxObject->FieldReadI() != 0);
+			SetParallelFrameBuildEnabled(FbxObject->FieldReadI() != 0);
+			SetRefreshCoalesceWindowMs(FbxObject->FieldReadI());
+			SetTransactionAwareRefreshEnabled(FbxObject->FieldReadI() != 0);
+			SetPacedSendingEnabled(FbxObject->FieldReadI() != 0);
+
+			// Skeletal sampling
+			FSkeletalSamplingSettings SamplingSettings;
+			const int32 SamplingModeInt = FbxObject->FieldReadI();
+			SamplingSettings.Mode = SamplingModeInt == (int32)ESkeletalSamplingMode::SkeletalSampling_Local ? ESkeletalSamplingMode::SkeletalSampling_Local : ESkeletalSamplingMode::SkeletalSampling_Global;
+			SamplingSettings.ParallelBoneThreshold = FbxObject->FieldReadI();
+			SamplingSettings.bCacheStaticBones = FbxObject->FieldReadI() != 0;
+			SetSkeletalSamplingSettings(SamplingSettings);
+
+			// Idle and render rates
+			SetIdleKeepAliveMs(FbxObject->FieldReadI());
+			SetIdleSendRate(FbxObject->FieldReadI());
+			SetMaxRenderSendRate(FbxObject->FieldReadI());
 			FbxObject->FieldReadEnd();
 
 			SetRefreshUI(true);
@@ -439,7 +961,22 @@ bool FMobuLiveLink::FbxRetrieve(FBFbxObject* FbxObject, kFbxObjectStore StoreWha
 	return true;
 }
 
-void FMobuLiveLink::FbxRetrieveV4(FBFbxObject* pFbxObject, kFbxObjectStore pStoreWhat)
+void FMobuLiveLink::FbxRetrieveV5(FBFbxObject* FbxObject, kFbxObjectStore StoreWhat, TArray<StreamObjectPtr>* OutRecordObjects)
+{
+	FbxRetrieveV4(FbxObject, StoreWhat, OutRecordObjects);
+
+	// Unicast endpoint
+	SetUnicastEndpoint(CharToFString(FbxObject->FieldReadC()));
+
+	// Static endpoints
+	const int StaticEndpointNum = FbxObject->FieldReadI();
+	for (int i = 0; i < StaticEndpointNum; ++i)
+	{
+		AddStaticEndpoint(CharToFString(FbxObject->FieldReadC()));
+	}
+}
+
+void FMobuLiveLink::FbxRetrieveV4(FBFbxObject* pFbxObject, kFbxObjectStore pStoreWhat, TArray<StreamObjectPtr>* OutRecordObjects)
 {
 	// Provider Name
 	SetProviderName(CharToFString(pFbxObject->FieldReadC()));
@@ -456,20 +993,24 @@ void FMobuLiveLink::FbxRetrieveV4(FBFbxObject* pFbxObject, kFbxObjectStore pStor
 	const int32 CurrentSampleIndex = pFbxObject->FieldReadI();
 	if (CurrentSampleIndex > 0 && CurrentSampleIndex < SampleOptions.Num())
 	{
-		CurrentSampleRate = SampleOptions[CurrentSampleIndex].Value;
+		// The custom rate itself is only stored by V6, which applies it once read
+		const FFrameRate& SampleOption = SampleOptions[CurrentSampleIndex].Value;
+		CurrentSampleRate = SampleOption == FFrameRate(-4, 1) ? CustomSampleRate : SampleOption;
 		UpdateSampleRate();
 	}
 
 	// NumberOfObjects
 	const int32 NumberOfObjects = pFbxObject->FieldReadI();
 
+	TArray<TPair<int32, StreamObjectPtr>> LoadedObjects;
+	LoadedObjects.Reserve(NumberOfObjects);
 	for (int32 i = 0; i < NumberOfObjects; ++i)
 	{
 		FBComponentList FoundModels;
 		FString StreamObjectRootName(pFbxObject->FieldReadC());
 		FBFindObjectsByName(TCHAR_TO_UTF8(*StreamObjectRootName), FoundModels, true, false);
 
-		if (FoundModels.GetCount() > 0)
+		if (FoundModels.GetCount() > 0 && FindUIDByModel((FBModel*)FoundModels[0]) == nullptr)
 		{
 			FBModel* FoundFBModel = (FBModel*)FoundModels[0];
 			TSharedPtr<IStreamObject> FoundStreamObject = StreamObjectManagement::FBModelToStreamObject(FoundFBModel);
@@ -486,7 +1027,11 @@ void FMobuLiveLink::FbxRetrieveV4(FBFbxObject* pFbxObject, kFbxObjectStore pStor
 			FoundStreamObject->UpdateSendAnimatableStatus(bStreamOAnimatableActive);
 
 			// Add the object last so the SubjectName is correct
-			AddStreamObject(GetNextUID(), FoundStreamObject);
+			LoadedObjects.Emplace(GetNextUID(), FoundStreamObject);
+			if (OutRecordObjects)
+			{
+				OutRecordObjects->Add(FoundStreamObject);
+			}
 		}
 		else
 		{
@@ -494,8 +1039,15 @@ void FMobuLiveLink::FbxRetrieveV4(FBFbxObject* pFbxObject, kFbxObjectStore pStor
 			pFbxObject->FieldReadI();
 			pFbxObject->FieldReadI();
 			pFbxObject->FieldReadI();
+			if (OutRecordObjects)
+			{
+				OutRecordObjects->Add(nullptr);
+			}
 		}
 	}
+
+	// Publish the whole scene as a single registry version
+	AddStreamObjects(LoadedObjects);
 }
 
 
@@ -508,8 +1060,16 @@ void FMobuLiveLink::StartLiveLink()
 	}
 
 	LiveLinkProvider = ILiveLinkProvider::CreateLiveLinkProvider(GetProviderName());
+	if (bUseSenderThread)
+	{
+		Sender = MakeUnique<FMobuLiveLinkSender>(LiveLinkProvider);
+		UpdateSenderPacing();
+	}
 
-	UpdateStreamObjects();
+	// A new provider knows nothing about our subjects
+	SentStaticData.Empty();
+	MarkAllStreamObjectsDirty();
+	RefreshStreamObjects(GetStreamObjects());
 	
 	FBTrace("Live Link Provider '%s' started!\n", FStringToChar(GetProviderName()));
 }
@@ -518,6 +1078,10 @@ void FMobuLiveLink::StartLiveLink()
 void FMobuLiveLink::StopLiveLink()
 {
 	TickCoreTicker();
+
+	// Joins the sender thread after it flushed everything still queued
+	Sender.Reset();
+
 	if (LiveLinkProvider.IsValid())
 	{
 		FBTrace("LiveLinkProvider References: %d\n", LiveLinkProvider.GetSharedReferenceCount());
@@ -527,9 +1091,24 @@ void FMobuLiveLink::StopLiveLink()
 	FBTrace("Live Link Provider '%s' stopped!\n", FStringToChar(GetProviderName()));
 }
 
+void FMobuLiveLink::EventUIIdle(HISender Sender, HKEvent Event)
+{
+	// Changing the transport rate or the reference time source raises no scene event
+	TimecodeService.CheckTransportSettings();
+
+	if (bDrivenModelsStale && SkeletalSamplingSettings.bCacheStaticBones)
+	{
+		UpdateDrivenModels();
+	}
+}
+
 void FMobuLiveLink::EventSceneChange(HISender Sender, HKEvent Event)
 {
 	FBEventSceneChange SceneChangeEvent = Event;
+
+	// Any edit, selection included, brings streaming back to full rate
+	LastSceneActivityTime = FPlatformTime::Seconds();
+
 	switch (SceneChangeEvent.Type)
 	{
 	case kFBSceneChangeSelect:
@@ -539,38 +1118,177 @@ void FMobuLiveLink::EventSceneChange(HISender Sender, HKEvent Event)
 	case kFBSceneChangeSoftSelect:
 	case kFBSceneChangeSoftUnselect:
 	case kFBSceneChangeHardSelect:
+		return;
 	case kFBSceneChangeTransactionBegin:
+	case kFBSceneChangeMergeTransactionBegin:
+		// Interactive manipulation holds a transaction open from mouse down to mouse up
+		++OpenSceneTransactions;
+		if (bTransactionAwareRefresh)
+		{
+			++SceneTransactionDepth;
+		}
+		return;
 	case kFBSceneChangeTransactionEnd:
+		OpenSceneTransactions = FMath::Max(OpenSceneTransactions - 1, 0);
+		if (bTransactionAwareRefresh && SceneTransactionDepth > 0)
+		{
+			--SceneTransactionDepth;
+		}
+		DeferRefresh();
 		return;
 	case kFBSceneChangeLoadBegin:
 		// Crashes if you try and stream while loading a new file
 		DeviceOperation(FBDevice::kOpStop);
 		return;
-	default:
-		SetDirty(true);
+	case kFBSceneChangeMergeTransactionEnd:
+		OpenSceneTransactions = FMath::Max(OpenSceneTransactions - 1, 0);
+		if (bTransactionAwareRefresh && SceneTransactionDepth > 0)
+		{
+			--SceneTransactionDepth;
+		}
+		// Anything may have changed, rebuild every subject once
+		bDrivenModelsStale = true;
+		MarkAllStreamObjectsDirty();
+		DeferRefresh();
+		return;
+	case kFBSceneChangeLoadEnd:
+	case kFBSceneChangeClearEnd:
+		// Never stay blocked on a transaction that was interrupted by the load
+		SceneTransactionDepth = 0;
+		OpenSceneTransactions = 0;
+		// The loaded scene brings its own transport settings
+		TimecodeService.Invalidate();
+		RevalidateStreamObjects();
+		if (SkeletalSamplingSettings.bCacheStaticBones)
+		{
+			// Every subject is rebuilt next, gather before rather than dirtying them again at idle
+			DrivenModels.Gather();
+			bDrivenModelsStale = false;
+		}
+		MarkAllStreamObjectsDirty();
+		DeferRefresh();
+		return;
+	case kFBSceneChangeDestroy:
+		InvalidateStaticBones(SceneChangeEvent.Component);
+		UpdateRootInScene(SceneChangeEvent.Component, false);
+		// Objects streaming the model stop sampling it until they are rebuilt, the others only forget about it
+		MarkStreamObjectsDirtyForComponent(SceneChangeEvent.Component);
+		NotifyHierarchyEdit(SceneChangeEvent.Component, true);
+		DeferRefresh();
 		break;
-	}
+	case kFBSceneChangeDetach:
+		InvalidateStaticBones(SceneChangeEvent.Component);
+		UpdateRootInScene(SceneChangeEvent.Component, false);
+		NotifyHierarchyEdit(SceneChangeEvent.Component, false);
+		DeferRefresh();
+		break;
+	case kFBSceneChangeAttach:
+		InvalidateStaticBones(SceneChangeEvent.Component);
+		UpdateRootInScene(SceneChangeEvent.Component, true);
+		NotifyHierarchyEdit(SceneChangeEvent.Component, false);
+		DeferRefresh();
+		break;
+	case kFBSceneChangeAddChild:
+	case kFBSceneChangeRemoveChild:
+		// Reparenting, the child moves and keeps its own subtree
+		NotifyHierarchyEdit(SceneChangeEvent.ChildComponent, false);
+		DeferRefresh();
+		break;
+	case kFBSceneChangeRenamed:
+	case kFBSceneChangeRenamedPrefix:
+	case kFBSceneChangeRenamedUnique:
+	case kFBSceneChangeRenamedUniquePrefix:
+	{
+		// Renaming a streamed root changes its RootName key
+		FBComponent* Component = SceneChangeEvent.Component;
+		const int32* UID = FBIS(Component, FBModel) ? FindUIDByModel((FBModel*)Component) : nullptr;
+		TSharedPtr<IStreamObject> StreamObject = UID ? FindStreamObject(*UID) : nullptr;
+		if (StreamObject.IsValid())
+		{
+			ReindexRootName(*UID, StreamObject);
+		}
+		MarkStreamObjectsDirtyForComponent(Component);
+		DeferRefresh();
+		break;
+	}
+	default:
+		InvalidateStaticBones(SceneChangeEvent.Component);
+		InvalidateStaticBones(SceneChangeEvent.ChildComponent);
+		MarkStreamObjectsDirtyForComponent(SceneChangeEvent.Component);
+		MarkStreamObjectsDirtyForComponent(SceneChangeEvent.ChildComponent);
+		DeferRefresh();
+		break;
+	}
 
 }
 
 void FMobuLiveLink::AddStreamObject(int32 NewUID, StreamObjectPtr NewObject)
 {
-	if (NewObject->IsValid())
+	AddStreamObjects({ TPair<int32, StreamObjectPtr>(NewUID, NewObject) });
+}
+
+void FMobuLiveLink::AddStreamObjects(const TArray<TPair<int32, StreamObjectPtr>>& NewObjects)
+{
+	TArray<TPair<int32, StreamObjectPtr>> ValidObjects;
+	ValidObjects.Reserve(NewObjects.Num());
+	for (const TPair<int32, StreamObjectPtr>& NewObject : NewObjects)
+	{
+		if (NewObject.Value->IsValid())
+		{
+			FBTrace("Added new Subject '%s' to StreamObjects\n", FStringToChar(NewObject.Value->GetSubjectName().ToString()));
+			NewObject.Value->UpdateSkeletalSamplingSettings(SkeletalSamplingSettings);
+			NewObject.Value->UpdateDrivenModels(&DrivenModels);
+			ValidObjects.Add(NewObject);
+		}
+	}
+
+	if (ValidObjects.Num() == 0)
+	{
+		return;
+	}
+
+	StreamObjectRegistry.Modify([&ValidObjects](FMobuStreamObjectRegistry::FStreamObjectMap& StreamObjects)
 	{
-		FBTrace("Added new Subject '%s' to StreamObjects\n", FStringToChar(NewObject->GetSubjectName().ToString()));
-		StreamObjects.Emplace(NewUID, NewObject);
+		for (const TPair<int32, StreamObjectPtr>& NewObject : ValidObjects)
+		{
+			StreamObjects.Emplace(NewObject.Key, NewObject.Value);
+		}
+	});
 
-		SetDirty(true);
+	for (const TPair<int32, StreamObjectPtr>& NewObject : ValidObjects)
+	{
+		IndexStreamObject(NewObject.Key, NewObject.Value);
 	}
+
+	SetDirty(true);
 }
 
 void FMobuLiveLink::RemoveStreamObject(int32 DeletionKey, StreamObjectPtr RemoveObject)
 {
-	FBTrace("Removed Subject '%s' from StreamObjects\n", FStringToChar(RemoveObject->GetSubjectName().ToString()));
-	StreamObjects.Remove(DeletionKey);
-	LiveLinkProvider->RemoveSubject(RemoveObject->GetSubjectName());
+	RemoveStreamObjects({ TPair<int32, StreamObjectPtr>(DeletionKey, RemoveObject) });
+}
 
-	SetDirty(true);
+void FMobuLiveLink::RemoveStreamObjects(const TArray<TPair<int32, StreamObjectPtr>>& RemoveObjects)
+{
+	if (RemoveObjects.Num() == 0)
+	{
+		return;
+	}
+
+	StreamObjectRegistry.Modify([&RemoveObjects](FMobuStreamObjectRegistry::FStreamObjectMap& StreamObjects)
+	{
+		for (const TPair<int32, StreamObjectPtr>& RemoveObject : RemoveObjects)
+		{
+			StreamObjects.Remove(RemoveObject.Key);
+		}
+	});
+
+	for (const TPair<int32, StreamObjectPtr>& RemoveObject : RemoveObjects)
+	{
+		FBTrace("Removed Subject '%s' from StreamObjects\n", FStringToChar(RemoveObject.Value->GetSubjectName().ToString()));
+		UnindexStreamObject(RemoveObject.Key, RemoveObject.Value);
+		PendingSubjectRemovals.Enqueue(RemoveObject.Value->GetSubjectName());
+	}
 }
 
 void FMobuLiveLink::ChangeSubjectName(StreamObjectPtr ObjectPtr, const char* NewSubjectNameStr)
@@ -578,37 +1296,617 @@ void FMobuLiveLink::ChangeSubjectName(StreamObjectPtr ObjectPtr, const char* New
 	if (ObjectPtr->GetSubjectName() != NewSubjectNameStr)
 	{
 		FBTrace("Subject Name changed from '%s' to '%s'\n", FStringToChar(ObjectPtr->GetSubjectName().ToString()), NewSubjectNameStr);
-		LiveLinkProvider->RemoveSubject(ObjectPtr->GetSubjectName());
-		ObjectPtr->UpdateSubjectName(FName(NewSubjectNameStr));
 
-		SetDirty(true);
+		const FName NewSubjectName(NewSubjectNameStr);
+		const int32* ExistingUID = FindUIDBySubjectName(NewSubjectName);
+		if (ExistingUID && FindStreamObject(*ExistingUID) != ObjectPtr)
+		{
+			FBTrace("WARNING - Subject Name '%s' is already streamed by another object\n", NewSubjectNameStr);
+		}
+
+		// Through the writer side lookups. A duplicate subject name may point at another object, the model lookup settles it
+		const FName OldSubjectName = ObjectPtr->GetSubjectName();
+		const int32* FoundUID = FindUIDBySubjectName(OldSubjectName);
+		if ((FoundUID == nullptr || FindStreamObject(*FoundUID) != ObjectPtr) && ObjectPtr->GetModelPointer() != nullptr)
+		{
+			FoundUID = FindUIDByModel(ObjectPtr->GetModelPointer());
+		}
+		const int32 UID = FoundUID ? *FoundUID : INDEX_NONE;
+
+		PendingSubjectRemovals.Enqueue(OldSubjectName);
+		ObjectPtr->UpdateSubjectName(NewSubjectName);
+
+		// Only the subject name changed, the model and root name entries stay as they are
+		if (UID != INDEX_NONE)
+		{
+			RemoveIndexEntry(SubjectNameToUID, OldSubjectName, UID);
+			SubjectNameToUID.Add(NewSubjectName, UID);
+		}
+
+		MarkStreamObjectDirty(ObjectPtr);
 	}
 }
 
+int32 FMobuLiveLink::AddStreamObjectsFromSpec(const FString& Spec, FString& OutReport)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<FString> Lines;
+	Spec.ParseIntoArrayLines(Lines);
+
+	TArray<TPair<int32, StreamObjectPtr>> NewObjects;
+	NewObjects.Reserve(Lines.Num());
+
+	TSet<const FBModel*> BatchModels;
+	TSet<FName> BatchSubjectNames;
+	int32 SkippedCount = 0;
+
+	for (const FString& RawLine : Lines)
+	{
+		const FString Line = RawLine.TrimStartAndEnd();
+		if (Line.IsEmpty() || Line.StartsWith(TEXT("#")))
+		{
+			continue;
+		}
+
+		TArray<FString> Fields;
+		Line.ParseIntoArray(Fields, TEXT("|"), false);
+		for (FString& Field : Fields)
+		{
+			Field.TrimStartAndEndInline();
+		}
+
+		FBModel* Model = FBFindModelByLabelName(TCHAR_TO_UTF8(*Fields[0]));
+		if (Model == nullptr || Model == FBSystem().Scene->RootModel)
+		{
+			FBTrace("Batch - Model '%s' not found, skipped\n", FStringToChar(Fields[0]));
+			++SkippedCount;
+			continue;
+		}
+
+		if (FindUIDByModel(Model) || BatchModels.Contains(Model))
+		{
+			FBTrace("Batch - Model '%s' is already streamed, skipped\n", FStringToChar(Fields[0]));
+			++SkippedCount;
+			continue;
+		}
+
+		StreamObjectPtr NewObject = StreamObjectManagement::FBModelToStreamObject(Model);
+		if (!NewObject.IsValid() || !NewObject->IsValid())
+		{
+			++SkippedCount;
+			continue;
+		}
+
+		if (Fields.IsValidIndex(1) && !Fields[1].IsEmpty())
+		{
+			NewObject->UpdateSubjectName(FName(*Fields[1]));
+		}
+
+		if (Fields.IsValidIndex(2) && !Fields[2].IsEmpty())
+		{
+			TArray<FString> StreamOptions;
+			NewObject->GetStreamOptions().ParseIntoArray(StreamOptions, TEXT("~"));
+
+			int32 StreamingMode = Fields[2].IsNumeric() ? FCString::Atoi(*Fields[2]) : StreamOptions.IndexOfByKey(Fields[2]);
+			if (StreamOptions.IsValidIndex(StreamingMode))
+			{
+				NewObject->UpdateStreamingMode(StreamingMode);
+			}
+			else
+			{
+				FBTrace("Batch - Unknown streaming mode '%s' for '%s', keeping default\n", FStringToChar(Fields[2]), FStringToChar(Fields[0]));
+			}
+		}
+
+		if (Fields.IsValidIndex(3) && !Fields[3].IsEmpty())
+		{
+			NewObject->UpdateActiveStatus(FCString::ToBool(*Fields[3]));
+		}
+
+		if (Fields.IsValidIndex(4) && !Fields[4].IsEmpty())
+		{
+			NewObject->UpdateSendAnimatableStatus(FCString::ToBool(*Fields[4]));
+		}
+
+		const FName SubjectName = NewObject->GetSubjectName();
+		if (FindUIDBySubjectName(SubjectName) || BatchSubjectNames.Contains(SubjectName))
+		{
+			FBTrace("WARNING - Subject Name '%s' is already streamed by another object\n", FStringToChar(SubjectName.ToString()));
+		}
+
+		BatchModels.Add(Model);
+		BatchSubjectNames.Add(SubjectName);
+		NewObjects.Emplace(GetNextUID(), NewObject);
+	}
+
+	// One registry version, one static data refresh and one UI rebuild for the whole batch
+	AddStreamObjects(NewObjects);
+	if (NewObjects.Num() > 0)
+	{
+		SetRefreshUI(true);
+	}
+
+	const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	OutReport = FString::Printf(TEXT("Added %d subjects, skipped %d, in %.2f ms"), NewObjects.Num(), SkippedCount, ElapsedMs);
+	FBTrace("Batch - %s\n", FStringToChar(OutReport));
+
+	return NewObjects.Num();
+}
+
+const int32* FMobuLiveLink::FindUIDByModel(const FBModel* Model) const
+{
+	return ModelToUID.Find(Model);
+}
+
+const int32* FMobuLiveLink::FindUIDByRootName(const FString& RootName) const
+{
+	return RootNameToUID.Find(RootName);
+}
+
+const int32* FMobuLiveLink::FindUIDBySubjectName(FName SubjectName) const
+{
+	return SubjectNameToUID.Find(SubjectName);
+}
+
+void FMobuLiveLink::IndexStreamObject(int32 UID, const StreamObjectPtr& StreamObject)
+{
+	if (const FBModel* Model = StreamObject->GetModelPointer())
+	{
+		ModelToUID.Add(Model, UID);
+	}
+
+	const FString RootName = StreamObject->GetRootName();
+	if (!RootName.IsEmpty())
+	{
+		RootNameToUID.Add(RootName, UID);
+	}
+
+	SubjectNameToUID.Add(StreamObject->GetSubjectName(), UID);
+}
+
+void FMobuLiveLink::UnindexStreamObject(int32 UID, const StreamObjectPtr& StreamObject)
+{
+	// Names are not required to be unique, another object may own the entry by now
+	if (const FBModel* Model = StreamObject->GetModelPointer())
+	{
+		RemoveIndexEntry(ModelToUID, Model, UID);
+	}
+
+	RemoveIndexEntry(RootNameToUID, StreamObject->GetRootName(), UID);
+	RemoveIndexEntry(SubjectNameToUID, StreamObject->GetSubjectName(), UID);
+}
+
+void FMobuLiveLink::ReindexRootName(int32 UID, const StreamObjectPtr& StreamObject)
+{
+	// The root was renamed in the scene, the old key is unknown so drop whatever pointed at this object
+	for (TMap<FString, int32>::TIterator It(RootNameToUID); It; ++It)
+	{
+		if (It.Value() == UID)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	const FString RootName = StreamObject->GetRootName();
+	if (!RootName.IsEmpty())
+	{
+		RootNameToUID.Add(RootName, UID);
+	}
+}
+
+TSharedPtr<IStreamObject> FMobuLiveLink::FindStreamObject(int32 UID) const
+{
+	const TSharedPtr<IStreamObject>* Found = GetStreamObjects().Find(UID);
+	return Found ? *Found : TSharedPtr<IStreamObject>();
+}
+
 void FMobuLiveLink::UpdateStreamObjects()
 {
-	decltype(StreamObjects) StreamObjectsToRemove;
+	RemoveInvalidStreamObjects();
+
+	// While online the evaluation refreshes dirty objects itself, the UI thread never competes with it for the lock
+	if (!Online && IsDirty() && IsRefreshDue())
+	{
+		StreamUpdateLock.Lock();
+		FlushPendingSubjectRemovals();
+		if (bIsDirty.exchange(false))
+		{
+			RefreshStreamObjects(GetStreamObjects());
+		}
+		StreamUpdateLock.Unlock();
+	}
+}
+
+void FMobuLiveLink::MarkStreamObjectDirty(const TSharedPtr<IStreamObject>& StreamObject)
+{
+	StreamObject->MarkDirty();
+	SetDirty(true);
+}
 
-	for (TPair<int32, TSharedPtr<IStreamObject>>& MapPair : StreamObjects)
+void FMobuLiveLink::MarkAllStreamObjectsDirty()
+{
+	for (const TPair<int32, TSharedPtr<IStreamObject>>& MapPair : GetStreamObjects())
+	{
+		MapPair.Value->MarkDirty();
+	}
+	SetDirty(true);
+}
+
+void FMobuLiveLink::MarkStreamObjectsDirtyForComponent(FBComponent* Component)
+{
+	if (Component == nullptr || !FBIS(Component, FBModel))
+	{
+		return;
+	}
+
+	// Every stream object rooted at the model or one of its ancestors contains it
+	for (FBModel* Ancestor = (FBModel*)Component; Ancestor != nullptr; Ancestor = Ancestor->Parent)
+	{
+		if (const int32* UID = FindUIDByModel(Ancestor))
+		{
+			if (TSharedPtr<IStreamObject> StreamObject = FindStreamObject(*UID))
+			{
+				MarkStreamObjectDirty(StreamObject);
+			}
+		}
+	}
+
+	// The viewport camera is not rooted at a model of its own
+	TSharedPtr<IStreamObject> EditorCameraObjectPin = EditorCameraObject.Pin();
+	if (EditorCameraObjectPin.IsValid() && EditorCameraObjectPin->IsModelInHierarchy((FBModel*)Component))
+	{
+		MarkStreamObjectDirty(EditorCameraObjectPin);
+	}
+}
+
+void FMobuLiveLink::NotifyHierarchyEdit(FBComponent* Component, bool bDestroyed)
+{
+	if (Component == nullptr || !FBIS(Component, FBModel))
+	{
+		return;
+	}
+
+	// The model may be leaving a hierarchy we can no longer reach from its new parent, so every object hears about it
+	for (const TPair<int32, TSharedPtr<IStreamObject>>& MapPair : GetStreamObjects())
+	{
+		MapPair.Value->NotifyHierarchyEdit((FBModel*)Component, bDestroyed);
+	}
+	SetDirty(true);
+}
+
+void FMobuLiveLink::InvalidateStaticBones(FBComponent* Component)
+{
+	if (!SkeletalSamplingSettings.bCacheStaticBones || Component == nullptr)
+	{
+		return;
+	}
+
+	// Constraints and characters can drive any model of the scene, the scene is walked once at the next idle for every subject
+	if (FBIS(Component, FBConstraint) || FBIS(Component, FBCharacter))
+	{
+		bDrivenModelsStale = true;
+	}
+}
+
+void FMobuLiveLink::UpdateDrivenModels()
+{
+	bDrivenModelsStale = false;
+
+	// Models that stopped being driven only keep their bones sampled, the next rebuild of their subject caches them
+	TArray<const FBModel*> NewlyDrivenModels;
+	DrivenModels.Gather(&NewlyDrivenModels);
+	for (const FBModel* Model : NewlyDrivenModels)
+	{
+		MarkStreamObjectsDirtyForComponent(const_cast<FBModel*>(Model));
+	}
+
+	if (NewlyDrivenModels.Num() > 0)
+	{
+		DeferRefresh();
+	}
+}
+
+void FMobuLiveLink::UpdateRootInScene(FBComponent* Component, bool bInScene)
+{
+	if (Component == nullptr)
+	{
+		return;
+	}
+
+	const int32* UID = FindUIDByModel((FBModel*)Component);
+	if (UID == nullptr)
+	{
+		return;
+	}
+
+	if (TSharedPtr<IStreamObject> StreamObject = FindStreamObject(*UID))
+	{
+		StreamObject->NotifyRootInScene(bInScene);
+		if (!bInScene)
+		{
+			bHasInvalidStreamObjects = true;
+		}
+	}
+}
+
+void FMobuLiveLink::RevalidateStreamObjects()
+{
+	// One pass over the scene instead of one search per object
+	FBScene* Scene = FBSystem().Scene;
+	const int32 ComponentCount = Scene->Components.GetCount();
+
+	TSet<const FBComponent*> SceneComponents;
+	SceneComponents.Reserve(ComponentCount);
+	for (int32 ComponentIndex = 0; ComponentIndex < ComponentCount; ++ComponentIndex)
+	{
+		SceneComponents.Add(Scene->Components[ComponentIndex]);
+	}
+
+	for (const TPair<int32, TSharedPtr<IStreamObject>>& MapPair : GetStreamObjects())
+	{
+		const FBModel* Model = MapPair.Value->GetModelPointer();
+		if (Model != nullptr)
+		{
+			const bool bInScene = SceneComponents.Contains(Model);
+			MapPair.Value->NotifyRootInScene(bInScene);
+			if (!bInScene)
+			{
+				bHasInvalidStreamObjects = true;
+			}
+		}
+	}
+}
+
+void FMobuLiveLink::DeferRefresh()
+{
+	if (RefreshCoalesceWindowMs > 0)
+	{
+		RefreshNotBefore = FPlatformTime::Seconds() + RefreshCoalesceWindowMs / 1000.0;
+	}
+}
+
+bool FMobuLiveLink::IsRefreshDue() const
+{
+	if (SceneTransactionDepth > 0)
+	{
+		return false;
+	}
+	return RefreshCoalesceWindowMs <= 0 || FPlatformTime::Seconds() >= RefreshNotBefore;
+}
+
+void FMobuLiveLink::SetRefreshCoalesceWindowMs(int32 InWindowMs)
+{
+	RefreshCoalesceWindowMs = FMath::Max(InWindowMs, 0);
+}
+
+void FMobuLiveLink::SetIdleKeepAliveMs(int32 InKeepAliveMs)
+{
+	IdleKeepAliveMs = FMath::Max(InKeepAliveMs, 0);
+}
+
+void FMobuLiveLink::SetTransactionAwareRefreshEnabled(bool bEnabled)
+{
+	bTransactionAwareRefresh = bEnabled;
+	if (!bTransactionAwareRefresh)
+	{
+		SceneTransactionDepth = 0;
+	}
+}
+
+void FMobuLiveLink::RefreshStreamObjects(const TMap<int32, TSharedPtr<IStreamObject>>& InStreamObjects)
+{
+	bool bRefreshedAny = false;
+	for (const TPair<int32, TSharedPtr<IStreamObject>>& MapPair : InStreamObjects)
 	{
 		const TSharedPtr<IStreamObject>& StreamObject = MapPair.Value;
+		if (!StreamObject->ConsumeDirty())
+		{
+			continue;
+		}
+
+		bRefreshedAny = true;
 		if (StreamObject->IsValid())
 		{
-			StreamObject->Refresh(LiveLinkProvider);
+			if (!StreamObject->ApplyHierarchyEdits())
+			{
+				// The edits were about models we do not stream
+				continue;
+			}
+
+			TSubclassOf<ULiveLinkRole> Role;
+			FLiveLinkStaticDataStruct StaticData;
+			if (StreamObject->Refresh(Role, StaticData))
+			{
+				// UE rebuilds the subject and drops its buffered frames on every static data, only send what changed
+				const FName SubjectName = StreamObject->GetSubjectName();
+				const uint32 StaticDataHash = MobuUtilities::HashStaticData(Role.Get(), StaticData);
+				const FSentStaticData* Sent = SentStaticData.Find(SubjectName);
+				if (Sent == nullptr || Sent->Hash != StaticDataHash)
+				{
+					FSentStaticData& NewSent = SentStaticData.Add(SubjectName);
+					NewSent.Hash = StaticDataHash;
+					NewSent.Generation = ++StaticDataGeneration;
+					SendSubjectStaticData(SubjectName, Role, MoveTemp(StaticData));
+				}
+			}
 		}
 		else
+		{
+			// Removal publishes a new registry version, leave it to the UI thread
+			bHasInvalidStreamObjects = true;
+		}
+	}
+
+	if (bRefreshedAny)
+	{
+		SetRefreshUI(true);
+	}
+}
+
+void FMobuLiveLink::RemoveInvalidStreamObjects()
+{
+	if (!bHasInvalidStreamObjects.exchange(false))
+	{
+		return;
+	}
+
+	TArray<TPair<int32, TSharedPtr<IStreamObject>>> StreamObjectsToRemove;
+	for (const TPair<int32, TSharedPtr<IStreamObject>>& MapPair : GetStreamObjects())
+	{
+		if (!MapPair.Value->IsValid())
 		{
 			StreamObjectsToRemove.Add(MapPair);
 		}
 	}
 
-	for (const auto& MapPair : StreamObjectsToRemove)
+	if (StreamObjectsToRemove.Num() > 0)
+	{
+		RemoveStreamObjects(StreamObjectsToRemove);
+		SetRefreshUI(true);
+	}
+}
+
+void FMobuLiveLink::FlushPendingSubjectRemovals()
+{
+	FName SubjectName;
+	while (PendingSubjectRemovals.Dequeue(SubjectName))
+	{
+		if (LiveLinkProvider.IsValid())
+		{
+			SendRemoveSubject(SubjectName);
+		}
+	}
+}
+
+void FMobuLiveLink::SendSubjectStaticData(FName SubjectName, TSubclassOf<ULiveLinkRole> Role, FLiveLinkStaticDataStruct&& StaticData)
+{
+	if (Sender.IsValid())
+	{
+		Sender->EnqueueStaticData(SubjectName, Role, MoveTemp(StaticData));
+	}
+	else
+	{
+		LiveLinkProvider->UpdateSubjectStaticData(SubjectName, Role, MoveTemp(StaticData));
+	}
+}
+
+void FMobuLiveLink::SendSubjectFrameData(FName SubjectName, const FLiveLinkFrameDataStruct& FrameData)
+{
+#if !UE_BUILD_SHIPPING
+	// The provider keeps a copy of every frame, and a ring slot last used by another kind of subject is rebuilt for this one
+	MobuUtilities::FScopedAllocationCounterExclusion SendExclusion;
+#endif
+
+	if (Sender.IsValid())
+	{
+		// Copied into a pooled slot, the frame keeps its buffers for the next evaluation
+		Sender->EnqueueFrameData(SubjectName, FrameData);
+	}
+	else
+	{
+		// Same as the sender, the provider gets its own copy so the job keeps its buffers for the next evaluation
+		FLiveLinkFrameDataStruct ProviderFrameData;
+		ProviderFrameData.InitializeWith(FrameData.GetStruct(), FrameData.GetBaseData());
+		LiveLinkProvider->UpdateSubjectFrameData(SubjectName, MoveTemp(ProviderFrameData));
+	}
+}
+
+void FMobuLiveLink::SendRemoveSubject(FName SubjectName)
+{
+	SentStaticData.Remove(SubjectName);
+	if (Sender.IsValid())
+	{
+		Sender->EnqueueRemoveSubject(SubjectName);
+	}
+	else
+	{
+		LiveLinkProvider->RemoveSubject(SubjectName);
+	}
+}
+
+void FMobuLiveLink::SetSenderThreadEnabled(bool bEnabled)
+{
+	if (bEnabled == bUseSenderThread)
+	{
+		return;
+	}
+
+	StreamUpdateLock.Lock();
+	bUseSenderThread = bEnabled;
+	if (bUseSenderThread && LiveLinkProvider.IsValid())
+	{
+		Sender = MakeUnique<FMobuLiveLinkSender>(LiveLinkProvider);
+		UpdateSenderPacing();
+	}
+	else
+	{
+		Sender.Reset();
+	}
+	StreamUpdateLock.Unlock();
+
+	FBTrace("MobuLiveLink Sender thread %s\n", bUseSenderThread ? "enabled" : "disabled");
+}
+
+void FMobuLiveLink::SetPacedSendingEnabled(bool bEnabled)
+{
+	bPacedSending = bEnabled;
+	UpdateSenderPacing();
+
+	FBTrace("MobuLiveLink Paced sending %s\n", bPacedSending ? "enabled" : "disabled");
+}
+
+FMobuPacingStats FMobuLiveLink::GetPacingStats() const
+{
+	return Sender.IsValid() ? Sender->GetPacingStats() : FMobuPacingStats();
+}
+
+void FMobuLiveLink::UpdateSenderPacing()
+{
+	if (Sender.IsValid())
+	{
+		// Before Render has no rate of its own, the redraws keep pacing the sends
+		const bool bPace = bPacedSending && CurrentSampleRate.Numerator > 0;
+		Sender->SetPacingRate(bPace ? CurrentSampleRate : FFrameRate(0, 1));
+	}
+}
+
+void FMobuLiveLink::SetParallelFrameBuildEnabled(bool bEnabled)
+{
+	bParallelFrameBuild = bEnabled;
+
+	FBTrace("MobuLiveLink Parallel frame build %s\n", bParallelFrameBuild ? "enabled" : "disabled");
+}
+
+void FMobuLiveLink::SetSkeletalSamplingSettings(const FSkeletalSamplingSettings& InSettings)
+{
+	// Static bones are classified for a sampling mode, with the static data
+	const bool bReclassifyBones = InSettings.Mode != SkeletalSamplingSettings.Mode || InSettings.bCacheStaticBones != SkeletalSamplingSettings.bCacheStaticBones;
+
+	const bool bStartCaching = InSettings.bCacheStaticBones && !SkeletalSamplingSettings.bCacheStaticBones;
+
+	SkeletalSamplingSettings = InSettings;
+	SkeletalSamplingSettings.ParallelBoneThreshold = FMath::Max(SkeletalSamplingSettings.ParallelBoneThreshold, 0);
+
+	// Scene edits are not tracked while caching is off
+	if (bStartCaching)
+	{
+		DrivenModels.Gather();
+		bDrivenModelsStale = false;
+	}
+	for (const TPair<int32, StreamObjectPtr>& StreamObject : GetStreamObjects())
+	{
+		StreamObject.Value->UpdateSkeletalSamplingSettings(SkeletalSamplingSettings);
+	}
+
+	if (bReclassifyBones)
 	{
-		RemoveStreamObject(MapPair.Key, MapPair.Value);
+		MarkAllStreamObjectsDirty();
 	}
 
-	SetDirty(false);
-	SetRefreshUI(true);
+	FBTrace("MobuLiveLink Skeletal sampling in %s space, parallel from %d bones, static bones %s\n",
+		SkeletalSamplingSettings.Mode == ESkeletalSamplingMode::SkeletalSampling_Local ? "local" : "global", SkeletalSamplingSettings.ParallelBoneThreshold,
+		SkeletalSamplingSettings.bCacheStaticBones ? "cached" : "sampled");
 }
 
 void FMobuLiveLink::TickCoreTicker()
@@ -639,6 +1937,7 @@ void FMobuLiveLink::SetEditorCameraStreamed(bool bStream)
 	if (EditorCameraObjectPin.IsValid())
 	{
 		EditorCameraObjectPin->UpdateActiveStatus(bStream);
+		MarkStreamObjectDirty(EditorCameraObjectPin);
 	}
 }
 
@@ -678,9 +1977,11 @@ void FMobuLiveLink::SetProviderName(const FString& NewValue)
 {
 	if (NewValue != GetProviderName())
 	{
+		StreamUpdateLock.Lock();
 		StopLiveLink();
 		CurrentProviderName = NewValue;
 		StartLiveLink();
+		StreamUpdateLock.Unlock();
 
 		SetRefreshUI(true);
 	}
@@ -703,6 +2004,7 @@ void FMobuLiveLink::SetUnicastEndpoint(const FString& InEndpoint)
 	{
 		if (IModularFeatures::Get().IsModularFeatureAvailable(INetworkMessagingExtension::ModularFeatureName))
 		{
+			StreamUpdateLock.Lock();
 			StopLiveLink();
 			UUdpMessagingSettings* Settings = GetMutableDefault<UUdpMessagingSettings>();
 			Settings->UnicastEndpoint = InEndpoint;
@@ -710,6 +2012,7 @@ void FMobuLiveLink::SetUnicastEndpoint(const FString& InEndpoint)
 			NetworkExtension.RestartServices();
 
 			StartLiveLink();
+			StreamUpdateLock.Unlock();
 			SetRefreshUI(true);
 		}
 	}
@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MobuLiveLinkDrivenModels.h"
+
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	void GatherModelTemplateModels(FBModelTemplate* Template, TSet<const FBModel*>& OutModels)
+	{
+		if (Template == nullptr)
+		{
+			return;
+		}
+
+		if (FBModel* Model = Template->Model)
+		{
+			OutModels.Add(Model);
+		}
+
+		const int ChildCount = Template->Children.GetCount();
+		for (int ChildIndex = 0; ChildIndex < ChildCount; ++ChildIndex)
+		{
+			GatherModelTemplateModels(Template->Children[ChildIndex], OutModels);
+		}
+	}
+
+	// Models referenced by a box of a relation constraint, sources included since a relation can write back into them
+	void GatherRelationModels(FBConstraintRelation* Relation, TSet<const FBModel*>& OutModels)
+	{
+		const int SrcCount = Relation->GetSrcCount();
+		for (int SrcIndex = 0; SrcIndex < SrcCount; ++SrcIndex)
+		{
+			FBPlug* Plug = Relation->GetSrc(SrcIndex);
+			if (Plug && FBIS(Plug, FBModelPlaceHolder))
+			{
+				if (FBModel* Model = ((FBModelPlaceHolder*)Plug)->Model)
+				{
+					OutModels.Add(Model);
+				}
+			}
+		}
+
+		const int DstCount = Relation->GetDstCount();
+		for (int DstIndex = 0; DstIndex < DstCount; ++DstIndex)
+		{
+			FBPlug* Plug = Relation->GetDst(DstIndex);
+			if (Plug && FBIS(Plug, FBModelPlaceHolder))
+			{
+				if (FBModel* Model = ((FBModelPlaceHolder*)Plug)->Model)
+				{
+					OutModels.Add(Model);
+				}
+			}
+		}
+	}
+
+	void GatherSceneDrivenModels(TSet<const FBModel*>& OutModels)
+	{
+		FBScene* Scene = FBSystem().Scene;
+
+		const int ConstraintCount = Scene->Constraints.GetCount();
+		for (int ConstraintIndex = 0; ConstraintIndex < ConstraintCount; ++ConstraintIndex)
+		{
+			// Inactive constraints included, activating one is not a scene change
+			FBConstraint* Constraint = Scene->Constraints[ConstraintIndex];
+			if (FBIS(Constraint, FBConstraintRelation))
+			{
+				GatherRelationModels((FBConstraintRelation*)Constraint, OutModels);
+			}
+
+			const int GroupCount = Constraint->ReferenceGroupGetCount();
+			for (int GroupIndex = 0; GroupIndex < GroupCount; ++GroupIndex)
+			{
+				const int ReferenceCount = Constraint->ReferenceGetCount(GroupIndex);
+				for (int ReferenceIndex = 0; ReferenceIndex < ReferenceCount; ++ReferenceIndex)
+				{
+					if (FBModel* Model = Constraint->ReferenceGet(GroupIndex, ReferenceIndex))
+					{
+						OutModels.Add(Model);
+					}
+				}
+			}
+		}
+
+		const int CharacterCount = Scene->Characters.GetCount();
+		for (int CharacterIndex = 0; CharacterIndex < CharacterCount; ++CharacterIndex)
+		{
+			FBCharacter* Character = Scene->Characters[CharacterIndex];
+			for (int NodeId = 0; NodeId < kFBLastNodeId; ++NodeId)
+			{
+				if (FBModel* Model = Character->GetModel((FBBodyNodeId)NodeId))
+				{
+					OutModels.Add(Model);
+				}
+			}
+		}
+
+		// Devices write the models bound to their model template on every evaluation
+		const int DeviceCount = Scene->Devices.GetCount();
+		for (int DeviceIndex = 0; DeviceIndex < DeviceCount; ++DeviceIndex)
+		{
+			GatherModelTemplateModels(&Scene->Devices[DeviceIndex]->ModelTemplate, OutModels);
+		}
+	}
+}
+
+void FMobuDrivenModels::Gather(TArray<const FBModel*>* OutNewlyDrivenModels)
+{
+	TSharedRef<FModelSet, ESPMode::ThreadSafe> NewModels = MakeShared<FModelSet, ESPMode::ThreadSafe>();
+	GatherSceneDrivenModels(*NewModels);
+
+	// Models that stopped being driven may be gone already, they are never read and their bones only stay sampled
+	if (OutNewlyDrivenModels)
+	{
+		const TSharedRef<const FModelSet, ESPMode::ThreadSafe> OldModels = Get();
+		for (const FBModel* Model : *NewModels)
+		{
+			if (!OldModels->Contains(Model))
+			{
+				OutNewlyDrivenModels->Add(Model);
+			}
+		}
+	}
+
+	FScopeLock Lock(&ModelsLock);
+	Models = NewModels;
+}
+
+TSharedRef<const FMobuDrivenModels::FModelSet, ESPMode::ThreadSafe> FMobuDrivenModels::Get() const
+{
+	FScopeLock Lock(&ModelsLock);
+	return Models;
+}
@@ -180,6 +180,9 @@ void FMobuLiveLinkLayout::UICreateLayout1()
 
 	const char SampleRateLabelName[] = "SampleRateLabel";
 	const char SampleRateListName[] = "SampleRateList";
+	const char CustomSampleRateNumeratorName[] = "CustomSampleRateNumerator";
+	const char CustomSampleRateSeparatorName[] = "CustomSampleRateSeparator";
+	const char CustomSampleRateDenominatorName[] = "CustomSampleRateDenominator";
 	const char ProviderNameLabelName[] = "ProviderNameLabel";
 	const char ProviderNameTextName[] = "ProviderNameText";
 	const char ProviderNameEditButtonName[] = "ProviderNameEditButton";
@@ -192,6 +195,23 @@ void FMobuLiveLinkLayout::UICreateLayout1()
 	const char StaticEndpointAddressName[] = "StaticEndpointAddress";
 	const char StaticEndpointAddButtonName[] = "StaticEndpointAddButton";
 	const char StaticEndpointRemoveButtonName[] = "StaticEndpointRemoveButton";
+	const char SenderThreadButtonName[] = "SenderThreadButton";
+	const char ParallelFrameBuildButtonName[] = "ParallelFrameBuildButton";
+	const char RefreshCoalesceLabelName[] = "RefreshCoalesceLabel";
+	const char RefreshCoalesceWindowName[] = "RefreshCoalesceWindow";
+	const char TransactionAwareButtonName[] = "TransactionAwareButton";
+	const char SkeletalSamplingModeLabelName[] = "SkeletalSamplingModeLabel";
+	const char SkeletalSamplingModeListName[] = "SkeletalSamplingModeList";
+	const char ParallelBoneThresholdLabelName[] = "ParallelBoneThresholdLabel";
+	const char ParallelBoneThresholdName[] = "ParallelBoneThreshold";
+	const char CacheStaticBonesButtonName[] = "CacheStaticBonesButton";
+	const char IdleKeepAliveLabelName[] = "IdleKeepAliveLabel";
+	const char IdleKeepAliveName[] = "IdleKeepAlive";
+	const char MaxRenderSendRateLabelName[] = "MaxRenderSendRateLabel";
+	const char MaxRenderSendRateName[] = "MaxRenderSendRate";
+	const char IdleSendRateLabelName[] = "IdleSendRateLabel";
+	const char IdleSendRateName[] = "IdleSendRate";
+	const char PacedSendingButtonName[] = "PacedSendingButton";
 
 	{
 		Layouts[1].AddRegion(SampleRateLabelName, SampleRateLabelName,
@@ -205,6 +225,24 @@ void FMobuLiveLinkLayout::UICreateLayout1()
 			0, kFBAttachTop, SampleRateLabelName, 1.00,
 			W, kFBAttachNone, nullptr, 1.00,
 			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(CustomSampleRateNumeratorName, CustomSampleRateNumeratorName,
+			S, kFBAttachRight, SampleRateListName, 1.00,
+			0, kFBAttachTop, SampleRateListName, 1.00,
+			W / 2, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(CustomSampleRateSeparatorName, CustomSampleRateSeparatorName,
+			S, kFBAttachRight, CustomSampleRateNumeratorName, 1.00,
+			0, kFBAttachTop, CustomSampleRateNumeratorName, 1.00,
+			S, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(CustomSampleRateDenominatorName, CustomSampleRateDenominatorName,
+			S, kFBAttachRight, CustomSampleRateSeparatorName, 1.00,
+			0, kFBAttachTop, CustomSampleRateSeparatorName, 1.00,
+			W / 2, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
 	}
 	{
 		Layouts[1].AddRegion(TimecodeModeListLabelName, TimecodeModeListLabelName,
@@ -282,9 +320,119 @@ void FMobuLiveLinkLayout::UICreateLayout1()
 			W, kFBAttachNone, nullptr, 1.00,
 			H, kFBAttachNone, nullptr, 1.00);
 	}
+	{
+		Layouts[1].AddRegion(SenderThreadButtonName, SenderThreadButtonName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			S, kFBAttachBottom, StaticEndpointAddressName, 1.00,
+			W * 2, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(ParallelFrameBuildButtonName, ParallelFrameBuildButtonName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			0, kFBAttachBottom, SenderThreadButtonName, 1.00,
+			W * 2, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+	}
+	{
+		Layouts[1].AddRegion(RefreshCoalesceLabelName, RefreshCoalesceLabelName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			0, kFBAttachBottom, ParallelFrameBuildButtonName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(RefreshCoalesceWindowName, RefreshCoalesceWindowName,
+			S, kFBAttachRight, RefreshCoalesceLabelName, 1.00,
+			0, kFBAttachTop, RefreshCoalesceLabelName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(TransactionAwareButtonName, TransactionAwareButtonName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			0, kFBAttachBottom, RefreshCoalesceLabelName, 1.00,
+			W * 2, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+	}
+	{
+		Layouts[1].AddRegion(SkeletalSamplingModeLabelName, SkeletalSamplingModeLabelName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			0, kFBAttachBottom, TransactionAwareButtonName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(SkeletalSamplingModeListName, SkeletalSamplingModeListName,
+			S, kFBAttachRight, SkeletalSamplingModeLabelName, 1.00,
+			0, kFBAttachTop, SkeletalSamplingModeLabelName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(ParallelBoneThresholdLabelName, ParallelBoneThresholdLabelName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			0, kFBAttachBottom, SkeletalSamplingModeLabelName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(ParallelBoneThresholdName, ParallelBoneThresholdName,
+			S, kFBAttachRight, ParallelBoneThresholdLabelName, 1.00,
+			0, kFBAttachTop, ParallelBoneThresholdLabelName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(CacheStaticBonesButtonName, CacheStaticBonesButtonName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			0, kFBAttachBottom, ParallelBoneThresholdLabelName, 1.00,
+			W * 2, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+	}
+	{
+		Layouts[1].AddRegion(IdleKeepAliveLabelName, IdleKeepAliveLabelName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			0, kFBAttachBottom, CacheStaticBonesButtonName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(IdleKeepAliveName, IdleKeepAliveName,
+			S, kFBAttachRight, IdleKeepAliveLabelName, 1.00,
+			0, kFBAttachTop, IdleKeepAliveLabelName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+	}
+	{
+		Layouts[1].AddRegion(MaxRenderSendRateLabelName, MaxRenderSendRateLabelName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			0, kFBAttachBottom, IdleKeepAliveLabelName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(MaxRenderSendRateName, MaxRenderSendRateName,
+			S, kFBAttachRight, MaxRenderSendRateLabelName, 1.00,
+			0, kFBAttachTop, MaxRenderSendRateLabelName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(IdleSendRateLabelName, IdleSendRateLabelName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			0, kFBAttachBottom, MaxRenderSendRateLabelName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(IdleSendRateName, IdleSendRateName,
+			S, kFBAttachRight, IdleSendRateLabelName, 1.00,
+			0, kFBAttachTop, IdleSendRateLabelName, 1.00,
+			W, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+
+		Layouts[1].AddRegion(PacedSendingButtonName, PacedSendingButtonName,
+			S, kFBAttachLeft, nullptr, 1.00,
+			0, kFBAttachBottom, IdleSendRateLabelName, 1.00,
+			W * 2, kFBAttachNone, nullptr, 1.00,
+			H, kFBAttachNone, nullptr, 1.00);
+	}
 
 	Layouts[1].SetControl(SampleRateLabelName, SampleRateListLabel);
 	Layouts[1].SetControl(SampleRateListName, SampleRateList);
+	Layouts[1].SetControl(CustomSampleRateNumeratorName, CustomSampleRateNumerator);
+	Layouts[1].SetControl(CustomSampleRateSeparatorName, CustomSampleRateSeparator);
+	Layouts[1].SetControl(CustomSampleRateDenominatorName, CustomSampleRateDenominator);
 	Layouts[1].SetControl(TimecodeModeListLabelName, TimecodeModeListLabel);
 	Layouts[1].SetControl(TimecodeModeListName, TimecodeModeList);
 	Layouts[1].SetControl(ProviderNameLabelName, ProviderNameLabel);
@@ -297,6 +445,23 @@ void FMobuLiveLinkLayout::UICreateLayout1()
 	Layouts[1].SetControl(StaticEndpointAddressName, StaticEndpoints);
 	Layouts[1].SetControl(StaticEndpointAddButtonName, StaticEndpointAddButton);
 	Layouts[1].SetControl(StaticEndpointRemoveButtonName, StaticEndpointRemoveButton);
+	Layouts[1].SetControl(SenderThreadButtonName, SenderThreadButton);
+	Layouts[1].SetControl(ParallelFrameBuildButtonName, ParallelFrameBuildButton);
+	Layouts[1].SetControl(RefreshCoalesceLabelName, RefreshCoalesceLabel);
+	Layouts[1].SetControl(RefreshCoalesceWindowName, RefreshCoalesceWindow);
+	Layouts[1].SetControl(TransactionAwareButtonName, TransactionAwareButton);
+	Layouts[1].SetControl(SkeletalSamplingModeLabelName, SkeletalSamplingModeLabel);
+	Layouts[1].SetControl(SkeletalSamplingModeListName, SkeletalSamplingModeList);
+	Layouts[1].SetControl(ParallelBoneThresholdLabelName, ParallelBoneThresholdLabel);
+	Layouts[1].SetControl(ParallelBoneThresholdName, ParallelBoneThreshold);
+	Layouts[1].SetControl(CacheStaticBonesButtonName, CacheStaticBonesButton);
+	Layouts[1].SetControl(IdleKeepAliveLabelName, IdleKeepAliveLabel);
+	Layouts[1].SetControl(IdleKeepAliveName, IdleKeepAlive);
+	Layouts[1].SetControl(MaxRenderSendRateLabelName, MaxRenderSendRateLabel);
+	Layouts[1].SetControl(MaxRenderSendRateName, MaxRenderSendRate);
+	Layouts[1].SetControl(IdleSendRateLabelName, IdleSendRateLabel);
+	Layouts[1].SetControl(IdleSendRateName, IdleSendRate);
+	Layouts[1].SetControl(PacedSendingButtonName, PacedSendingButton);
 }
 
 void FMobuLiveLinkLayout::CreateSpreadColumns()
@@ -316,6 +481,14 @@ void FMobuLiveLinkLayout::CreateSpreadColumns()
 	StreamSpread.ColumnAdd("Stream Animatable", 3);
 	StreamSpread.GetColumn(3).Style = kFBCellStyle2StatesButton;
 	StreamSpread.GetColumn(3).Width = W;
+
+	StreamSpread.ColumnAdd("Rate Divisor", 4);
+	StreamSpread.GetColumn(4).Style = kFBCellStyleInteger;
+	StreamSpread.GetColumn(4).Width = W * 0.8f;
+
+	StreamSpread.ColumnAdd("Max Rate (hz)", 5);
+	StreamSpread.GetColumn(5).Style = kFBCellStyleInteger;
+	StreamSpread.GetColumn(5).Width = W * 0.8f;
 }
 
 void FMobuLiveLinkLayout::UIConfigure()
@@ -367,20 +540,31 @@ void FMobuLiveLinkLayout::UIConfigureLayout1()
 		TimecodeModeListLabel.Caption = "Timecode:";
 	}
 
-	int CurrentSampleIndex = 0;
 	for (int SampleOptionIdx = 0; SampleOptionIdx < LiveLinkDevice->SampleOptions.Num(); ++SampleOptionIdx)
 	{
 		const TPair<FString, FFrameRate>& SampleOption = LiveLinkDevice->SampleOptions[SampleOptionIdx];
 		SampleRateList.Items.Add(FStringToChar(SampleOption.Key));
-		if (SampleOption.Value == LiveLinkDevice->CurrentSampleRate)
-		{
-			CurrentSampleIndex = SampleOptionIdx;
-		}
 	}
-	SampleRateList.ItemIndex = CurrentSampleIndex;
+	SampleRateList.ItemIndex = LiveLinkDevice->GetCurrentSampleRateIndex();
 
 	SampleRateList.OnChange.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventSampleRateChange);
 
+	// Used by the Custom option, frames per Denominator seconds so 24000 / 1001 is 23.976hz
+	const FFrameRate CustomSampleRate = LiveLinkDevice->GetCustomSampleRate();
+	CustomSampleRateNumerator.Min = 1.0;
+	CustomSampleRateNumerator.Max = 1000000.0;
+	CustomSampleRateNumerator.Precision = 0.0;
+	CustomSampleRateNumerator.Value = CustomSampleRate.Numerator;
+	CustomSampleRateNumerator.OnChange.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventCustomSampleRateChange);
+
+	CustomSampleRateSeparator.Caption = "/";
+
+	CustomSampleRateDenominator.Min = 1.0;
+	CustomSampleRateDenominator.Max = 1000000.0;
+	CustomSampleRateDenominator.Precision = 0.0;
+	CustomSampleRateDenominator.Value = CustomSampleRate.Denominator;
+	CustomSampleRateDenominator.OnChange.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventCustomSampleRateChange);
+
 	SampleRateListLabel.Caption = "Sample Rate:";
 	ProviderNameLabel.Caption = "Provider Name:";
 
@@ -404,6 +588,72 @@ void FMobuLiveLinkLayout::UIConfigureLayout1()
 
 	StaticEndpointRemoveButton.Caption = "Remove";
 	StaticEndpointRemoveButton.OnClick.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventRemoveStaticEndpoint);
+
+	SenderThreadButton.Caption = "Send on Worker Thread";
+	SenderThreadButton.Style = kFBCheckbox;
+	SenderThreadButton.State = LiveLinkDevice->IsSenderThreadEnabled();
+	SenderThreadButton.OnClick.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventSenderThreadChange);
+
+	ParallelFrameBuildButton.Caption = "Build Frames in Parallel";
+	ParallelFrameBuildButton.Style = kFBCheckbox;
+	ParallelFrameBuildButton.State = LiveLinkDevice->IsParallelFrameBuildEnabled();
+	ParallelFrameBuildButton.OnClick.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventParallelFrameBuildChange);
+
+	RefreshCoalesceLabel.Caption = "Refresh Delay (ms):";
+	RefreshCoalesceWindow.Min = 0.0;
+	RefreshCoalesceWindow.Max = 10000.0;
+	RefreshCoalesceWindow.Precision = 0.0;
+	RefreshCoalesceWindow.Value = LiveLinkDevice->GetRefreshCoalesceWindowMs();
+	RefreshCoalesceWindow.OnChange.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventRefreshCoalesceWindowChange);
+
+	TransactionAwareButton.Caption = "Wait for Scene Transactions";
+	TransactionAwareButton.Style = kFBCheckbox;
+	TransactionAwareButton.State = LiveLinkDevice->IsTransactionAwareRefreshEnabled();
+	TransactionAwareButton.OnClick.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventTransactionAwareChange);
+
+	SkeletalSamplingModeLabel.Caption = "Skeleton Sampling:";
+	SkeletalSamplingModeList.Items.Add("Global");
+	SkeletalSamplingModeList.Items.Add("Local");
+	SkeletalSamplingModeList.ItemIndex = (int32)LiveLinkDevice->GetSkeletalSamplingSettings().Mode;
+	SkeletalSamplingModeList.OnChange.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventSkeletalSamplingModeChange);
+
+	ParallelBoneThresholdLabel.Caption = "Parallel Bone Count:";
+	ParallelBoneThreshold.Min = 0.0;
+	ParallelBoneThreshold.Max = 100000.0;
+	ParallelBoneThreshold.Precision = 0.0;
+	ParallelBoneThreshold.Value = LiveLinkDevice->GetSkeletalSamplingSettings().ParallelBoneThreshold;
+	ParallelBoneThreshold.OnChange.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventParallelBoneThresholdChange);
+
+	CacheStaticBonesButton.Caption = "Cache Static Bones";
+	CacheStaticBonesButton.Style = kFBCheckbox;
+	CacheStaticBonesButton.State = LiveLinkDevice->GetSkeletalSamplingSettings().bCacheStaticBones;
+	CacheStaticBonesButton.OnClick.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventCacheStaticBonesChange);
+
+	IdleKeepAliveLabel.Caption = "Idle Keep Alive (ms):";
+	IdleKeepAlive.Min = 0.0;
+	IdleKeepAlive.Max = 60000.0;
+	IdleKeepAlive.Precision = 0.0;
+	IdleKeepAlive.Value = LiveLinkDevice->GetIdleKeepAliveMs();
+	IdleKeepAlive.OnChange.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventIdleKeepAliveChange);
+
+	MaxRenderSendRateLabel.Caption = "Max Render Rate (hz):";
+	MaxRenderSendRate.Min = 0.0;
+	MaxRenderSendRate.Max = 1000.0;
+	MaxRenderSendRate.Precision = 0.0;
+	MaxRenderSendRate.Value = LiveLinkDevice->GetMaxRenderSendRate();
+	MaxRenderSendRate.OnChange.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventMaxRenderSendRateChange);
+
+	IdleSendRateLabel.Caption = "Idle Rate (hz):";
+	IdleSendRate.Min = 0.0;
+	IdleSendRate.Max = 1000.0;
+	IdleSendRate.Precision = 0.0;
+	IdleSendRate.Value = LiveLinkDevice->GetIdleSendRate();
+	IdleSendRate.OnChange.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventIdleSendRateChange);
+
+	PacedSendingButton.Caption = "Pace Worker Thread Sends";
+	PacedSendingButton.Style = kFBCheckbox;
+	PacedSendingButton.State = LiveLinkDevice->IsPacedSendingEnabled();
+	PacedSendingButton.OnClick.Add(this, (FBCallback)&FMobuLiveLinkLayout::EventPacedSendingChange);
 }
 
 void FMobuLiveLinkLayout::UIReset()
@@ -411,11 +661,29 @@ void FMobuLiveLinkLayout::UIReset()
 	FBTrace("UI Reset!\n");
 	StreamSpread.Clear();
 	CreateSpreadColumns();
-	for (const TPair<int32, StreamObjectPtr>& MapPair : LiveLinkDevice->StreamObjects)
+	for (const TPair<int32, StreamObjectPtr>& MapPair : LiveLinkDevice->GetStreamObjects())
 	{
 		AddSpreadRowFromStreamObject(MapPair.Key, MapPair.Value);
 	}
 	
+	SampleRateList.ItemIndex = LiveLinkDevice->GetCurrentSampleRateIndex();
+	CustomSampleRateNumerator.Value = LiveLinkDevice->GetCustomSampleRate().Numerator;
+	CustomSampleRateDenominator.Value = LiveLinkDevice->GetCustomSampleRate().Denominator;
+
+	SenderThreadButton.State = LiveLinkDevice->IsSenderThreadEnabled();
+	ParallelFrameBuildButton.State = LiveLinkDevice->IsParallelFrameBuildEnabled();
+	RefreshCoalesceWindow.Value = LiveLinkDevice->GetRefreshCoalesceWindowMs();
+	TransactionAwareButton.State = LiveLinkDevice->IsTransactionAwareRefreshEnabled();
+	PacedSendingButton.State = LiveLinkDevice->IsPacedSendingEnabled();
+
+	SkeletalSamplingModeList.ItemIndex = (int32)LiveLinkDevice->GetSkeletalSamplingSettings().Mode;
+	ParallelBoneThreshold.Value = LiveLinkDevice->GetSkeletalSamplingSettings().ParallelBoneThreshold;
+	CacheStaticBonesButton.State = LiveLinkDevice->GetSkeletalSamplingSettings().bCacheStaticBones;
+
+	IdleKeepAlive.Value = LiveLinkDevice->GetIdleKeepAliveMs();
+	IdleSendRate.Value = LiveLinkDevice->GetIdleSendRate();
+	MaxRenderSendRate.Value = LiveLinkDevice->GetMaxRenderSendRate();
+
 	UnicastEndpoint.Text = FStringToChar(LiveLinkDevice->GetUnicastEndpoint());
 	StaticEndpoints.Items.Clear();
 	const TArray<FString>& Endpoints = LiveLinkDevice->GetStaticEndpoints();
@@ -429,10 +697,7 @@ void FMobuLiveLinkLayout::UIReset()
 
 void FMobuLiveLinkLayout::EventUIIdle(HISender Sender, HKEvent Event)
 {
-	if (LiveLinkDevice->IsDirty())
-	{
-		LiveLinkDevice->UpdateStreamObjects();
-	}
+	LiveLinkDevice->UpdateStreamObjects();
 	if (LiveLinkDevice->ShouldRefreshUI())
 	{
 		UIReset();
@@ -453,26 +718,18 @@ void FMobuLiveLinkLayout::AddSpreadRowFromStreamObject(int32 NewRowKey, StreamOb
 	StreamSpread.SetCell(NewRowKey, 1, Object->GetStreamingMode());
 	StreamSpread.SetCell(NewRowKey, 2, Object->GetActiveStatus());
 	StreamSpread.SetCell(NewRowKey, 3, Object->GetSendAnimatableStatus());
+	StreamSpread.SetCell(NewRowKey, 4, Object->GetRateClass().Divisor);
+	StreamSpread.SetCell(NewRowKey, 5, Object->GetRateClass().MaxRate);
 }
 
 
-bool IsModelInDeviceStream(const FMobuLiveLink* MobuDevice, const FBModel* Model)
-{
-	for (const TPair<int32, TSharedPtr<IStreamObject>>& StreamPair : MobuDevice->StreamObjects)
-	{
-		if (StreamPair.Value->GetModelPointer() == Model)
-		{
-			return true;
-		}
-	}
-	return false;
-}
-
 void FMobuLiveLinkLayout::EventAddToStream(HISender Sender, HKEvent Event)
 {
-	TArray<FBModel*> ParentsToIgnore;
+	TSet<FBModel*> ParentsToIgnore;
 	ParentsToIgnore.Reserve(ObjectSelection.GetCount());
 
+	TArray<TPair<int32, StreamObjectPtr>> NewObjects;
+
 	FBModel* SceneRoot = FBSystem().Scene->RootModel;
 	for (int CharIndex = 0; CharIndex < ObjectSelection.GetCount(); ++CharIndex)
 	{
@@ -489,27 +746,31 @@ void FMobuLiveLinkLayout::EventAddToStream(HISender Sender, HKEvent Event)
 		{
 			ParentsToIgnore.Emplace(Model);
 		}
-		else if (!IsModelInDeviceStream(LiveLinkDevice, Model))
+		else if (LiveLinkDevice->FindUIDByModel(Model) == nullptr)
 		{
 			StreamObjectPtr StoreObject = StreamObjectManagement::FBModelToStreamObject(Model);
-			int32 NewUID = LiveLinkDevice->GetNextUID();
-
-			LiveLinkDevice->AddStreamObject(NewUID, StoreObject);
-			AddSpreadRowFromStreamObject(NewUID, StoreObject);
+			NewObjects.Emplace(LiveLinkDevice->GetNextUID(), StoreObject);
 
 			ParentsToIgnore.Emplace(Model);
 		}
 	}
 	ObjectSelection.Clear();
+
+	// Publish the whole selection at once rather than one registry version per model
+	LiveLinkDevice->AddStreamObjects(NewObjects);
+	for (const TPair<int32, StreamObjectPtr>& NewObject : NewObjects)
+	{
+		AddSpreadRowFromStreamObject(NewObject.Key, NewObject.Value);
+	}
 }
 
 void FMobuLiveLinkLayout::EventRemoveFromStream(HISender Sender, HKEvent Event)
 {
 	int SelectedCount = 0;
 
-	decltype(LiveLinkDevice->StreamObjects) StreamObjectsToRemove;
+	TArray<TPair<int32, StreamObjectPtr>> StreamObjectsToRemove;
 
-	for (const TPair<int32, StreamObjectPtr>& MapPair : LiveLinkDevice->StreamObjects)
+	for (const TPair<int32, StreamObjectPtr>& MapPair : LiveLinkDevice->GetStreamObjects())
 	{
 		int32 RowKey = MapPair.Key;
 		bool bRowSelected = StreamSpread.GetRow(RowKey).RowSelected;
@@ -520,10 +781,7 @@ void FMobuLiveLinkLayout::EventRemoveFromStream(HISender Sender, HKEvent Event)
 		}
 	}
 
-	for (const auto& MapPair : StreamObjectsToRemove)
-	{
-		LiveLinkDevice->RemoveStreamObject(MapPair.Key, MapPair.Value);
-	}
+	LiveLinkDevice->RemoveStreamObjects(StreamObjectsToRemove);
 
 	if (SelectedCount > 0)
 	{
@@ -542,8 +800,8 @@ void FMobuLiveLinkLayout::EventStreamSpreadCellChange(HISender Sender, HKEvent E
 {
 	FBEventSpread SpreadEvent = Event;
 
-	StreamObjectPtr* ObjectPtr = LiveLinkDevice->StreamObjects.Find(SpreadEvent.Row);
-	if (ObjectPtr == nullptr && ObjectPtr->IsValid())
+	StreamObjectPtr ObjectPtr = LiveLinkDevice->FindStreamObject(SpreadEvent.Row);
+	if (!ObjectPtr.IsValid())
 	{
 		FBTrace("No object exists for this Row!");
 		return;
@@ -554,35 +812,55 @@ void FMobuLiveLinkLayout::EventStreamSpreadCellChange(HISender Sender, HKEvent E
 	{
 		const char* NewSubjectName;
 		StreamSpread.GetCell(SpreadEvent.Row, SpreadEvent.Column, NewSubjectName);
-		LiveLinkDevice->ChangeSubjectName(*ObjectPtr, NewSubjectName);
+		LiveLinkDevice->ChangeSubjectName(ObjectPtr, NewSubjectName);
 		break;
 	}
 	case 1: // Stream Type
 	{
 		int RowIndex;
 		StreamSpread.GetCell(SpreadEvent.Row, SpreadEvent.Column, RowIndex);
-		(*ObjectPtr)->UpdateStreamingMode(RowIndex);
+		ObjectPtr->UpdateStreamingMode(RowIndex);
 		break;
 	}
 	case 2: // Stream Status
 	{
 		int bIsActive;
 		StreamSpread.GetCell(SpreadEvent.Row, SpreadEvent.Column, bIsActive);
-		(*ObjectPtr)->UpdateActiveStatus(bIsActive > 0);
+		ObjectPtr->UpdateActiveStatus(bIsActive > 0);
 		break;
 	}
 	case 3: // Stream Animatable
 	{
 		int bIsAnimatable;
 		StreamSpread.GetCell(SpreadEvent.Row, SpreadEvent.Column, bIsAnimatable);
-		(*ObjectPtr)->UpdateSendAnimatableStatus(bIsAnimatable > 0);
+		ObjectPtr->UpdateSendAnimatableStatus(bIsAnimatable > 0);
 		break;
 	}
+	case 4: // Rate Divisor
+	case 5: // Max Rate
+	{
+		int NewRate;
+		StreamSpread.GetCell(SpreadEvent.Row, SpreadEvent.Column, NewRate);
+
+		FStreamRateClass RateClass = ObjectPtr->GetRateClass();
+		if (SpreadEvent.Column == 4)
+		{
+			RateClass.Divisor = NewRate;
+		}
+		else
+		{
+			RateClass.MaxRate = NewRate;
+		}
+		ObjectPtr->UpdateRateClass(RateClass);
+
+		// The rate only changes scheduling, the static data stays valid
+		return;
+	}
 	default:
 		break;
 	}
 
-	LiveLinkDevice->SetDirty(true);
+	LiveLinkDevice->MarkStreamObjectDirty(ObjectPtr);
 }
 
 void FMobuLiveLinkLayout::EventTabPanelChange(HISender pSender, HKEvent pEvent)
@@ -605,7 +883,12 @@ void FMobuLiveLinkLayout::EventTimecodeModeChanged(HISender Sender, HKEvent Even
 
 void FMobuLiveLinkLayout::EventSampleRateChange(HISender Sender, HKEvent Event)
 {
-	const FFrameRate& NewSampleRate = LiveLinkDevice->SampleOptions[SampleRateList.ItemIndex].Value;
+	FFrameRate NewSampleRate = LiveLinkDevice->SampleOptions[SampleRateList.ItemIndex].Value;
+	if (NewSampleRate == FFrameRate(-4, 1))
+	{
+		NewSampleRate = LiveLinkDevice->GetCustomSampleRate();
+	}
+
 	if (NewSampleRate != LiveLinkDevice->CurrentSampleRate)
 	{
 		LiveLinkDevice->CurrentSampleRate = NewSampleRate;
@@ -613,6 +896,11 @@ void FMobuLiveLinkLayout::EventSampleRateChange(HISender Sender, HKEvent Event)
 	}
 }
 
+void FMobuLiveLinkLayout::EventCustomSampleRateChange(HISender Sender, HKEvent Event)
+{
+	LiveLinkDevice->SetCustomSampleRate(FFrameRate(FMath::RoundToInt((double)CustomSampleRateNumerator.Value), FMath::RoundToInt((double)CustomSampleRateDenominator.Value)));
+}
+
 void FMobuLiveLinkLayout::EventEditProviderNamePopup(HISender Sender, HKEvent Event)
 {
 	char NewNameString[1024];
@@ -697,6 +985,67 @@ void FMobuLiveLinkLayout::EventAddStaticEndpoint(HISender Sender, HKEvent Event)
 	}
 }
 
+void FMobuLiveLinkLayout::EventSenderThreadChange(HISender Sender, HKEvent Event)
+{
+	LiveLinkDevice->SetSenderThreadEnabled((bool)SenderThreadButton.State);
+}
+
+void FMobuLiveLinkLayout::EventParallelFrameBuildChange(HISender Sender, HKEvent Event)
+{
+	LiveLinkDevice->SetParallelFrameBuildEnabled((bool)ParallelFrameBuildButton.State);
+}
+
+void FMobuLiveLinkLayout::EventRefreshCoalesceWindowChange(HISender Sender, HKEvent Event)
+{
+	LiveLinkDevice->SetRefreshCoalesceWindowMs(FMath::RoundToInt((double)RefreshCoalesceWindow.Value));
+}
+
+void FMobuLiveLinkLayout::EventTransactionAwareChange(HISender Sender, HKEvent Event)
+{
+	LiveLinkDevice->SetTransactionAwareRefreshEnabled((bool)TransactionAwareButton.State);
+}
+
+void FMobuLiveLinkLayout::EventSkeletalSamplingModeChange(HISender Sender, HKEvent Event)
+{
+	FSkeletalSamplingSettings Settings = LiveLinkDevice->GetSkeletalSamplingSettings();
+	Settings.Mode = (ESkeletalSamplingMode)(int32)SkeletalSamplingModeList.ItemIndex;
+	LiveLinkDevice->SetSkeletalSamplingSettings(Settings);
+}
+
+void FMobuLiveLinkLayout::EventParallelBoneThresholdChange(HISender Sender, HKEvent Event)
+{
+	FSkeletalSamplingSettings Settings = LiveLinkDevice->GetSkeletalSamplingSettings();
+	Settings.ParallelBoneThreshold = FMath::RoundToInt((double)ParallelBoneThreshold.Value);
+	LiveLinkDevice->SetSkeletalSamplingSettings(Settings);
+}
+
+void FMobuLiveLinkLayout::EventMaxRenderSendRateChange(HISender Sender, HKEvent Event)
+{
+	LiveLinkDevice->SetMaxRenderSendRate(FMath::RoundToInt((double)MaxRenderSendRate.Value));
+}
+
+void FMobuLiveLinkLayout::EventIdleSendRateChange(HISender Sender, HKEvent Event)
+{
+	LiveLinkDevice->SetIdleSendRate(FMath::RoundToInt((double)IdleSendRate.Value));
+}
+
+void FMobuLiveLinkLayout::EventPacedSendingChange(HISender Sender, HKEvent Event)
+{
+	LiveLinkDevice->SetPacedSendingEnabled((bool)PacedSendingButton.State);
+}
+
+void FMobuLiveLinkLayout::EventIdleKeepAliveChange(HISender Sender, HKEvent Event)
+{
+	LiveLinkDevice->SetIdleKeepAliveMs(FMath::RoundToInt((double)IdleKeepAlive.Value));
+}
+
+void FMobuLiveLinkLayout::EventCacheStaticBonesChange(HISender Sender, HKEvent Event)
+{
+	FSkeletalSamplingSettings Settings = LiveLinkDevice->GetSkeletalSamplingSettings();
+	Settings.bCacheStaticBones = (bool)CacheStaticBonesButton.State;
+	LiveLinkDevice->SetSkeletalSamplingSettings(Settings);
+}
+
 void FMobuLiveLinkLayout::EventRemoveStaticEndpoint(HISender Sender, HKEvent Event)
 {
 	if (StaticEndpoints.ItemIndex == -1)
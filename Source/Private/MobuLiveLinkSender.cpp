@@ -0,0 +1,343 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MobuLiveLinkSender.h"
+#include "MobuLiveLinkUtilities.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	// The sender sleeps on its event, this only bounds how long a missed wake up can delay a batch
+	const uint32 SenderIdleWaitMs = 5;
+
+	// The event wait is only as precise as the OS timer, the last stretch before a deadline is spent yielding instead
+	const double PacingSpinSeconds = 0.002;
+}
+
+FMobuLiveLinkSender::FMobuLiveLinkSender(const TSharedPtr<ILiveLinkProvider>& InProvider, uint32 InCapacity)
+	: Provider(InProvider)
+	, Commands(InCapacity)
+{
+	check(Provider.IsValid());
+
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("MobuLiveLinkSender"), 0, TPri_AboveNormal);
+	FBTrace("MobuLiveLink Sender thread started\n");
+}
+
+FMobuLiveLinkSender::~FMobuLiveLinkSender()
+{
+	if (Thread)
+	{
+		// Stop() is called by Kill(), the thread drains what is left before exiting
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
+	FBTrace("MobuLiveLink Sender thread stopped, %llu frames dropped\n", GetDroppedFrameCount());
+}
+
+void FMobuLiveLinkSender::EnqueueStaticData(FName SubjectName, TSubclassOf<ULiveLinkRole> Role, FLiveLinkStaticDataStruct&& StaticData)
+{
+	FMobuLiveLinkSenderCommand* Command = Commands.BeginWrite();
+	while (Command == nullptr)
+	{
+		Wake();
+		FPlatformProcess::YieldThread();
+		Command = Commands.BeginWrite();
+	}
+
+	Command->Type = FMobuLiveLinkSenderCommand::EType::StaticData;
+	Command->SubjectName = SubjectName;
+	Command->Role = Role;
+	Command->StaticData = MoveTemp(StaticData);
+	Commands.EndWrite();
+}
+
+bool FMobuLiveLinkSender::EnqueueFrameData(FName SubjectName, const FLiveLinkFrameDataStruct& FrameData)
+{
+	if (IsPacing())
+	{
+		// Only the most recent pose of a subject is sent at the next deadline
+		FScopeLock Lock(&PacedFramesLock);
+		FPacedFrame& PacedFrame = PacedFrames.FindOrAdd(SubjectName);
+		MobuUtilities::CopyFrameData(FrameData, PacedFrame.FrameData);
+		PacedFrame.bIsNew = true;
+		return true;
+	}
+
+	FMobuLiveLinkSenderCommand* Command = Commands.BeginWrite();
+	if (Command == nullptr)
+	{
+		DroppedFrameCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	Command->Type = FMobuLiveLinkSenderCommand::EType::FrameData;
+	Command->SubjectName = SubjectName;
+	MobuUtilities::CopyFrameData(FrameData, Command->FrameData);
+	Commands.EndWrite();
+	return true;
+}
+
+void FMobuLiveLinkSender::EnqueueRemoveSubject(FName SubjectName)
+{
+	PendingRemovals.Enqueue(TPair<uint32, FName>(Commands.GetWriteSequence(), SubjectName));
+	Wake();
+}
+
+void FMobuLiveLinkSender::Wake()
+{
+	WakeEvent->Trigger();
+}
+
+void FMobuLiveLinkSender::SetPacingRate(FFrameRate InRate)
+{
+	const double Period = InRate.Numerator > 0 && InRate.Denominator > 0 ? InRate.AsInterval() : 0.0;
+	if (PacingPeriod.exchange(Period) != Period)
+	{
+		Wake();
+	}
+}
+
+FMobuPacingStats FMobuLiveLinkSender::GetPacingStats() const
+{
+	FScopeLock Lock(&PacingStatsLock);
+	return PacingStats;
+}
+
+uint32 FMobuLiveLinkSender::Run()
+{
+	while (!bStopRequested.load(std::memory_order_acquire))
+	{
+		const double Period = PacingPeriod.load(std::memory_order_acquire);
+		if (Period != ActivePeriod)
+		{
+			StopPacing();
+			StartPacing(Period);
+		}
+
+		if (ActivePeriod > 0.0)
+		{
+			if (WaitForDeadline())
+			{
+				SendPacedFrames();
+			}
+		}
+		else
+		{
+			DrainCommands();
+			WakeEvent->Wait(SenderIdleWaitMs);
+		}
+	}
+
+	// Flush whatever the producer published before we were asked to stop
+	DrainCommands();
+	StopPacing();
+	return 0;
+}
+
+void FMobuLiveLinkSender::Stop()
+{
+	bStopRequested.store(true, std::memory_order_release);
+	WakeEvent->Trigger();
+}
+
+void FMobuLiveLinkSender::ProcessRemovals(uint32 ReadSequence)
+{
+	// A removal waits until everything that was published before it has been sent
+	const TPair<uint32, FName>* Removal = PendingRemovals.Peek();
+	while (Removal && (int32)(ReadSequence - Removal->Key) >= 0)
+	{
+		Provider->RemoveSubject(Removal->Value);
+
+		// A paced frame taken before the removal must not bring the subject back
+		if (ActivePeriod > 0.0)
+		{
+			{
+				FScopeLock Lock(&PacedFramesLock);
+				PacedFrames.Remove(Removal->Value);
+			}
+			for (int32 FrameIdx = 0; FrameIdx < PacedFrameCount; ++FrameIdx)
+			{
+				if (PacedSubjectNames[FrameIdx] == Removal->Value)
+				{
+					PacedSubjectNames[FrameIdx] = NAME_None;
+				}
+			}
+		}
+
+		PendingRemovals.Pop();
+		Removal = PendingRemovals.Peek();
+	}
+}
+
+void FMobuLiveLinkSender::DrainCommands()
+{
+	ProcessRemovals(Commands.GetReadSequence());
+
+	while (FMobuLiveLinkSenderCommand* Command = Commands.BeginRead())
+	{
+		if (Command->Type == FMobuLiveLinkSenderCommand::EType::StaticData)
+		{
+			Provider->UpdateSubjectStaticData(Command->SubjectName, Command->Role, MoveTemp(Command->StaticData));
+		}
+		else
+		{
+			// The provider takes ownership of what it is given, so it gets its own copy and the slot keeps its buffers
+			// for the producer. That copy is the only allocation left on the send path and it stays on this thread
+			FLiveLinkFrameDataStruct FrameData;
+			FrameData.InitializeWith(Command->FrameData.GetStruct(), Command->FrameData.GetBaseData());
+			Provider->UpdateSubjectFrameData(Command->SubjectName, MoveTemp(FrameData));
+		}
+		Commands.EndRead();
+
+		ProcessRemovals(Commands.GetReadSequence());
+	}
+}
+
+void FMobuLiveLinkSender::StartPacing(double Period)
+{
+	ActivePeriod = Period;
+	if (ActivePeriod <= 0.0)
+	{
+		return;
+	}
+
+	{
+		FScopeLock Lock(&PacingStatsLock);
+		PacingStats = FMobuPacingStats();
+		PacingLatenessSum = 0.0;
+	}
+
+	PacingOrigin = FPlatformTime::Seconds();
+	PacingTick = 1;
+	NextDeadline = PacingOrigin + ActivePeriod;
+
+	FBTrace("MobuLiveLink Sender pacing at %f hz\n", 1.0 / ActivePeriod);
+}
+
+void FMobuLiveLinkSender::StopPacing()
+{
+	if (ActivePeriod <= 0.0)
+	{
+		return;
+	}
+
+	// Frames left in the mailbox are stale, the producer sends straight to the ring from now on
+	{
+		FScopeLock Lock(&PacedFramesLock);
+		PacedFrames.Empty();
+	}
+	PacedFrameCount = 0;
+
+	const FMobuPacingStats Stats = GetPacingStats();
+	FBTrace("MobuLiveLink Sender pacing at %f hz stopped: %llu deadlines, %llu missed, lateness mean %.3f ms max %.3f ms\n",
+		1.0 / ActivePeriod, Stats.TickCount, Stats.MissedTickCount, Stats.MeanLatenessMs, Stats.MaxLatenessMs);
+
+	ActivePeriod = 0.0;
+}
+
+bool FMobuLiveLinkSender::WaitForDeadline()
+{
+	for (;;)
+	{
+		const double Remaining = NextDeadline - FPlatformTime::Seconds();
+		if (Remaining <= 0.0)
+		{
+			break;
+		}
+
+		if (bStopRequested.load(std::memory_order_acquire) || PacingPeriod.load(std::memory_order_acquire) != ActivePeriod)
+		{
+			return false;
+		}
+
+		if (Remaining > PacingSpinSeconds)
+		{
+			// Static data and removals are not paced, they go out while we wait
+			WakeEvent->Wait(FMath::Max<uint32>((uint32)((Remaining - PacingSpinSeconds) * 1000.0), 1));
+			DrainCommands();
+		}
+		else
+		{
+			FPlatformProcess::YieldThread();
+		}
+	}
+
+	const double CurrentTime = FPlatformTime::Seconds();
+	const double LatenessMs = (CurrentTime - NextDeadline) * 1000.0;
+
+	// Deadlines are absolute, a late wake up never pushes back the ones after it. Whole periods we slept through are skipped
+	uint64 NextTick = PacingTick + 1;
+	const uint64 CurrentTick = (uint64)((CurrentTime - PacingOrigin) / ActivePeriod);
+	const uint64 MissedTicks = CurrentTick >= NextTick ? CurrentTick + 1 - NextTick : 0;
+	NextTick += MissedTicks;
+
+	PacingTick = NextTick;
+	NextDeadline = PacingOrigin + (double)PacingTick * ActivePeriod;
+
+	{
+		FScopeLock Lock(&PacingStatsLock);
+		++PacingStats.TickCount;
+		PacingStats.MissedTickCount += MissedTicks;
+		PacingLatenessSum += LatenessMs;
+		PacingStats.MeanLatenessMs = PacingLatenessSum / (double)PacingStats.TickCount;
+		PacingStats.MaxLatenessMs = FMath::Max(PacingStats.MaxLatenessMs, LatenessMs);
+	}
+
+	return true;
+}
+
+void FMobuLiveLinkSender::SendPacedFrames()
+{
+	PacedFrameCount = 0;
+	{
+		FScopeLock Lock(&PacedFramesLock);
+		for (TPair<FName, FPacedFrame>& PacedFrame : PacedFrames)
+		{
+			if (!PacedFrame.Value.bIsNew)
+			{
+				continue;
+			}
+
+			if (PacedFrameCount == PacedFrameData.Num())
+			{
+				PacedSubjectNames.AddDefaulted();
+				PacedFrameData.AddDefaulted();
+			}
+			// Swapped rather than copied, the mailbox gets the buffers of the frame sent at the previous deadline
+			PacedSubjectNames[PacedFrameCount] = PacedFrame.Key;
+			Swap(PacedFrame.Value.FrameData, PacedFrameData[PacedFrameCount]);
+			PacedFrame.Value.bIsNew = false;
+			++PacedFrameCount;
+		}
+	}
+
+	// Static data published before these frames has to reach the provider first
+	DrainCommands();
+
+	for (int32 FrameIdx = 0; FrameIdx < PacedFrameCount; ++FrameIdx)
+	{
+		if (PacedSubjectNames[FrameIdx].IsNone())
+		{
+			continue;
+		}
+
+		// Same as the ring, the scratch frame keeps its buffers so they can go back to the mailbox
+		FLiveLinkFrameDataStruct FrameData;
+		FrameData.InitializeWith(PacedFrameData[FrameIdx].GetStruct(), PacedFrameData[FrameIdx].GetBaseData());
+
+		// World time is taken as the deadline is served, so UE sees the paced spacing rather than the evaluation one
+		FrameData.GetBaseData()->WorldTime = FLiveLinkWorldTime();
+		Provider->UpdateSubjectFrameData(PacedSubjectNames[FrameIdx], MoveTemp(FrameData));
+	}
+	PacedFrameCount = 0;
+}
@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MobuLiveLinkStreamObjectRegistry.h"
+
+#include "Misc/ScopeLock.h"
+
+FMobuStreamObjectRegistry::FMobuStreamObjectRegistry()
+	: Current(new FSnapshot())
+{
+}
+
+FMobuStreamObjectRegistry::~FMobuStreamObjectRegistry()
+{
+	check(Hazard.load() == nullptr);
+
+	for (FSnapshot* Snapshot : Retired)
+	{
+		delete Snapshot;
+	}
+	Retired.Empty();
+
+	delete Current.load();
+}
+
+const FMobuStreamObjectRegistry::FSnapshot& FMobuStreamObjectRegistry::AcquireRead()
+{
+	// Publish the hazard, then make sure the version did not get replaced before it became visible to writers
+	FSnapshot* Snapshot = Current.load();
+	for (;;)
+	{
+		Hazard.store(Snapshot);
+		FSnapshot* Latest = Current.load();
+		if (Latest == Snapshot)
+		{
+			return *Snapshot;
+		}
+		Snapshot = Latest;
+	}
+}
+
+void FMobuStreamObjectRegistry::ReleaseRead()
+{
+	Hazard.store(nullptr);
+}
+
+const FMobuStreamObjectRegistry::FStreamObjectMap& FMobuStreamObjectRegistry::GetWriterView() const
+{
+	return Current.load()->StreamObjects;
+}
+
+uint64 FMobuStreamObjectRegistry::GetVersion() const
+{
+	return Current.load()->Version;
+}
+
+void FMobuStreamObjectRegistry::Add(int32 UID, const TSharedPtr<IStreamObject>& StreamObject)
+{
+	Modify([UID, &StreamObject](FStreamObjectMap& StreamObjects)
+	{
+		StreamObjects.Emplace(UID, StreamObject);
+	});
+}
+
+bool FMobuStreamObjectRegistry::Remove(int32 UID)
+{
+	bool bRemoved = false;
+	Modify([UID, &bRemoved](FStreamObjectMap& StreamObjects)
+	{
+		bRemoved = StreamObjects.Remove(UID) > 0;
+	});
+	return bRemoved;
+}
+
+void FMobuStreamObjectRegistry::Empty()
+{
+	Modify([](FStreamObjectMap& StreamObjects)
+	{
+		StreamObjects.Empty();
+	});
+}
+
+void FMobuStreamObjectRegistry::Modify(TFunctionRef<void(FStreamObjectMap&)> Edit)
+{
+	FScopeLock Lock(&WriteLock);
+
+	const FSnapshot* Latest = Current.load();
+
+	FSnapshot* NewSnapshot = new FSnapshot();
+	NewSnapshot->StreamObjects = Latest->StreamObjects;
+	NewSnapshot->Version = Latest->Version + 1;
+	Edit(NewSnapshot->StreamObjects);
+
+	Publish(NewSnapshot);
+}
+
+void FMobuStreamObjectRegistry::Publish(FSnapshot* NewSnapshot)
+{
+	// Caller holds WriteLock
+	FSnapshot* Previous = Current.exchange(NewSnapshot);
+	Retired.Add(Previous);
+	ReclaimRetired();
+}
+
+void FMobuStreamObjectRegistry::ReclaimRetired()
+{
+	// A retired version can only be protected if the reader picked it up before it was replaced
+	const FSnapshot* Protected = Hazard.load();
+	for (int32 Index = Retired.Num() - 1; Index >= 0; --Index)
+	{
+		if (Retired[Index] != Protected)
+		{
+			delete Retired[Index];
+			Retired.RemoveAtSwap(Index);
+		}
+	}
+}
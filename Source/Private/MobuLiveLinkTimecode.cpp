@@ -0,0 +1,129 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MobuLiveLinkTimecode.h"
+
+namespace
+{
+	const double SecondsPerDay = 24.0 * 60.0 * 60.0;
+
+	// Unique ID of the current reference time source, -1 while there is none
+	int GetCurrentReferenceTimeID(FBReferenceTime& ReferenceTime, int& OutSourceCount)
+	{
+		#if PRODUCT_VERSION >= 2019
+		FBArrayTemplate<int> Identifiers;
+		ReferenceTime.GetUniqueIDList(&Identifiers);
+		OutSourceCount = Identifiers.GetCount();
+		return OutSourceCount > 0 ? (int)ReferenceTime.CurrentTimeReferenceID : -1;
+		#else
+		OutSourceCount = ReferenceTime.Count;
+		return OutSourceCount > 0 ? (int)ReferenceTime.ItemIndex : -1;
+		#endif
+	}
+}
+
+FMobuTimecodeService::FMobuTimecodeService()
+	: FrameRate(30, 1)
+{
+}
+
+FQualifiedFrameTime FMobuTimecodeService::GetTimecode(ETimecodeMode TimecodeMode)
+{
+	if (!bIsCacheValid.exchange(true) || TimecodeMode != CachedTimecodeMode)
+	{
+		UpdateCache(TimecodeMode);
+	}
+
+	if (TimecodeMode == ETimecodeMode::TimecodeMode_System && !bIsTimeOfDayAligned.exchange(true))
+	{
+		// Both clocks are sampled back to back, the monotonic one then carries the time of day alone
+		TimeOfDayOffset = FDateTime::Now().GetTimeOfDay().GetTotalSeconds() - FPlatformTime::Seconds();
+	}
+
+	// Make sure we use the decimal frame time instead of the integer frame number to keep subframes
+	FFrameTime FrameTime;
+	switch (TimecodeMode)
+	{
+	case ETimecodeMode::TimecodeMode_Local:			// Local time (Take time)
+		FrameTime = FrameRate.AsFrameTime(FBSystem::TheOne().LocalTime.GetSecondDouble());
+		break;
+	case ETimecodeMode::TimecodeMode_System:		// System time (PC clock)
+		FrameTime = FrameRate.AsFrameTime(FMath::Fmod(FPlatformTime::Seconds() + TimeOfDayOffset, SecondsPerDay));
+		break;
+	case ETimecodeMode::TimecodeMode_Reference:		// Reference time (Incoming LTC)
+		if (ReferenceTimeID != -1)
+		{
+			FrameTime = FrameRate.AsFrameTime(ReferenceTime->GetTime(ReferenceTimeID, FBTime(0)).GetSecondDouble());
+		}
+		break;
+	}
+
+	return FQualifiedFrameTime(FrameTime, FrameRate);
+}
+
+bool FMobuTimecodeService::GetReferenceFrame(FFrameNumber& OutFrame)
+{
+	const bool bFirstRequest = !bReferenceFrameRequested;
+	bReferenceFrameRequested = true;
+
+	if (!bIsCacheValid.exchange(true) || bFirstRequest)
+	{
+		UpdateCache(CachedTimecodeMode);
+	}
+
+	if (ReferenceTimeID == -1)
+	{
+		OutFrame = FrameRate.AsFrameTime(FPlatformTime::Seconds()).GetFrame();
+		return false;
+	}
+
+	OutFrame = FrameRate.AsFrameTime(ReferenceTime->GetTime(ReferenceTimeID, FBTime(0)).GetSecondDouble()).GetFrame();
+	return true;
+}
+
+void FMobuTimecodeService::CheckTransportSettings()
+{
+	FBPlayerControl& PlayerControl = FBPlayerControl::TheOne();
+	const FBTimeMode TransportFps = PlayerControl.GetTransportFps();
+	const double TransportFpsValue = TransportFps == FBTimeMode::kFBTimeModeCustom ? PlayerControl.GetTransportFpsValue() : 0.0;
+
+	if (!ObservedReferenceTime.IsValid())
+	{
+		ObservedReferenceTime = MakeUnique<FBReferenceTime>();
+	}
+	int ReferenceTimeCount = 0;
+	const int CurrentReferenceTimeID = GetCurrentReferenceTimeID(*ObservedReferenceTime, ReferenceTimeCount);
+
+	if (TransportFps != ObservedTransportFps || TransportFpsValue != ObservedTransportFpsValue
+		|| CurrentReferenceTimeID != ObservedReferenceTimeID || ReferenceTimeCount != ObservedReferenceTimeCount)
+	{
+		ObservedTransportFps = TransportFps;
+		ObservedTransportFpsValue = TransportFpsValue;
+		ObservedReferenceTimeID = CurrentReferenceTimeID;
+		ObservedReferenceTimeCount = ReferenceTimeCount;
+		Invalidate();
+	}
+}
+
+void FMobuTimecodeService::UpdateCache(ETimecodeMode TimecodeMode)
+{
+	CachedTimecodeMode = TimecodeMode;
+	FrameRate = MobuUtilities::TimeModeToFrameRate(FBPlayerControl::TheOne().GetTransportFps());
+
+	ReferenceTimeID = -1;
+	if (TimecodeMode == ETimecodeMode::TimecodeMode_Reference || bReferenceFrameRequested)
+	{
+		if (!ReferenceTime.IsValid())
+		{
+			ReferenceTime = MakeUnique<FBReferenceTime>();
+		}
+
+		int ReferenceTimeCount = 0;
+		ReferenceTimeID = GetCurrentReferenceTimeID(*ReferenceTime, ReferenceTimeCount);
+
+		if (ReferenceTimeID == -1 && !bReportedMissingReference)
+		{
+			FBTrace("GetSceneTimecode - No Reference time sources\n");
+		}
+		bReportedMissingReference = ReferenceTimeID == -1;
+	}
+}
@@ -1,43 +1,37 @@
 ﻿// Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "MobuLiveLinkUtilities.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include "Serialization/Archive.h"
+
+#include "Roles/LiveLinkAnimationTypes.h"
+#include "Roles/LiveLinkCameraTypes.h"
+#include "Roles/LiveLinkLightTypes.h"
+#include "Roles/LiveLinkLocatorTypes.h"
+#include "Roles/LiveLinkTransformTypes.h"
+
+#include <atomic>
 
 const float MobuUtilities::InchesToMillimeters = 25.4f;
 
-FTransform MobuUtilities::MobuTransformToUnreal(FBMatrix MobuTransfrom)
+template<typename SpacePolicy>
+FTransform MobuUtilities::ConvertTransform(FBMatrix MobuTransform)
 {
-	FBMatrix MobuTransformUnrealSpace;
-	FBTVector TVector;
-	FBSVector SVector;
-	FBQuaternion Quat;
-	for (int j = 0; j < 4; ++j)
+	// Plain engine math on purpose, this is what the vectorized batch is checked against
+	FMatrix ConvertedTransform;
+	for (int Row = 0; Row < 4; ++Row)
 	{
-		if (j == 1)
-		{
-			MobuTransformUnrealSpace(j, 0) = -MobuTransfrom(j, 0);
-			MobuTransformUnrealSpace(j, 1) = MobuTransfrom(j, 1);
-			MobuTransformUnrealSpace(j, 2) = -MobuTransfrom(j, 2);
-			MobuTransformUnrealSpace(j, 3) = -MobuTransfrom(j, 3);
-		}
-		else
+		const int SourceRow = SpacePolicy::RowSource[Row];
+		for (int Column = 0; Column < 3; ++Column)
 		{
-			MobuTransformUnrealSpace(j, 0) = MobuTransfrom(j, 0);
-			MobuTransformUnrealSpace(j, 1) = -MobuTransfrom(j, 1);
-			MobuTransformUnrealSpace(j, 2) = MobuTransfrom(j, 2);
-			MobuTransformUnrealSpace(j, 3) = MobuTransfrom(j, 3);
+			ConvertedTransform.M[Row][Column] = SpacePolicy::RowSign[Row] * SpacePolicy::ColumnSign[Column] * MobuTransform(SourceRow, SpacePolicy::ColumnSource[Column]);
 		}
+		ConvertedTransform.M[Row][3] = Row == 3 ? 1.0 : 0.0;
 	}
+	ConvertedTransform.SetOrigin(ConvertedTransform.GetOrigin() * SpacePolicy::UnitScale);
 
-	FBMatrixToTranslation(TVector, MobuTransformUnrealSpace);
-	FBMatrixToQuaternion(Quat, MobuTransformUnrealSpace);
-	FBMatrixToScaling(SVector, MobuTransformUnrealSpace);
-
-	FTransform UnrealTransform;
-	UnrealTransform.SetRotation(FQuat(Quat[0], Quat[1], Quat[2], Quat[3]));
-	UnrealTransform.SetTranslation(FVector(TVector[0], TVector[1], TVector[2]));
-	UnrealTransform.SetScale3D(FVector(SVector[0], SVector[1], SVector[2]));
-
-	return UnrealTransform;
+	return FTransform(ConvertedTransform);
 }
 
 FColor MobuUtilities::MobuColorToUnreal(FBColor Color)
@@ -50,128 +44,946 @@ FColor MobuUtilities::MobuColorToUnreal(FBColor Color)
 	return Result;
 }
 
-FTransform MobuUtilities::UnrealTransformFromModel(FBModel* MobuModel, bool bIsGlobal)
+template<typename SpacePolicy>
+void MobuUtilities::ConvertTransforms(const FBMatrix* MobuTransforms, int32 Count, FTransform* OutTransforms)
 {
-	FBMatrix MobuTransform;
-	FBMatrix MatOffset;
+	typedef SpacePolicy P;
 
-	MobuModel->GetMatrix(MobuTransform, kModelTransformation, bIsGlobal, nullptr);
+	// Row and column signs folded into one mask per row, the unit scale only applies to the translation
+	const VectorRegister4Double AxisSignX = MakeVectorRegisterDouble(P::RowSign[0] * P::ColumnSign[0], P::RowSign[0] * P::ColumnSign[1], P::RowSign[0] * P::ColumnSign[2], 0.0);
+	const VectorRegister4Double AxisSignY = MakeVectorRegisterDouble(P::RowSign[1] * P::ColumnSign[0], P::RowSign[1] * P::ColumnSign[1], P::RowSign[1] * P::ColumnSign[2], 0.0);
+	const VectorRegister4Double AxisSignZ = MakeVectorRegisterDouble(P::RowSign[2] * P::ColumnSign[0], P::RowSign[2] * P::ColumnSign[1], P::RowSign[2] * P::ColumnSign[2], 0.0);
+	const VectorRegister4Double TranslationSign = MakeVectorRegisterDouble(
+		P::UnitScale * P::RowSign[3] * P::ColumnSign[0], P::UnitScale * P::RowSign[3] * P::ColumnSign[1], P::UnitScale * P::RowSign[3] * P::ColumnSign[2], 0.0);
+	const VectorRegister4Double MinScaleSquared = MakeVectorRegisterDouble(UE_SMALL_NUMBER, UE_SMALL_NUMBER, UE_SMALL_NUMBER, UE_SMALL_NUMBER);
 
-	// Y-Up Correction
-	FBRVector RotOffset(90, 0, 0);
-	FBRotationToMatrix(MatOffset, RotOffset);
-	FBMatrixMult(MobuTransform, MatOffset, MobuTransform);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const double* MobuTransform = (const double*)MobuTransforms[Index];
 
-	return MobuTransformToUnreal(MobuTransform);
-};
+		// Rows are picked and their components shuffled with compile time indices
+		const VectorRegister4Double AxisX = VectorMultiply(VectorSwizzle(VectorLoad(MobuTransform + 4 * P::RowSource[0]), P::ColumnSource[0], P::ColumnSource[1], P::ColumnSource[2], 3), AxisSignX);
+		const VectorRegister4Double AxisY = VectorMultiply(VectorSwizzle(VectorLoad(MobuTransform + 4 * P::RowSource[1]), P::ColumnSource[0], P::ColumnSource[1], P::ColumnSource[2], 3), AxisSignY);
+		const VectorRegister4Double AxisZ = VectorMultiply(VectorSwizzle(VectorLoad(MobuTransform + 4 * P::RowSource[2]), P::ColumnSource[0], P::ColumnSource[1], P::ColumnSource[2], 3), AxisSignZ);
+		const VectorRegister4Double Translation = VectorMultiply(VectorSwizzle(VectorLoad(MobuTransform + 4 * P::RowSource[3]), P::ColumnSource[0], P::ColumnSource[1], P::ColumnSource[2], 3), TranslationSign);
 
-// Get all properties on a given model that are both Animatable and are of a Type we can stream
-TArray<FName> MobuUtilities::GetAllAnimatableCurveNames(FBModel* MobuModel, const FString& Prefix)
-{
-	const int PropertyCount = MobuModel->PropertyList.GetCount();
+		// Scale is the length of each axis, degenerate axes are left at zero rather than dividing by zero
+		const VectorRegister4Double LengthSquaredX = VectorDot3(AxisX, AxisX);
+		const VectorRegister4Double LengthSquaredY = VectorDot3(AxisY, AxisY);
+		const VectorRegister4Double LengthSquaredZ = VectorDot3(AxisZ, AxisZ);
 
-	TArray<FName> LiveLinkCurves;
-	// Reserve enough memory for worst case
-	LiveLinkCurves.Reserve(PropertyCount);
+		VectorRegister4Double UnitX = VectorSelect(VectorCompareGT(LengthSquaredX, MinScaleSquared), VectorMultiply(AxisX, VectorReciprocalSqrt(LengthSquaredX)), VectorZeroDouble());
+		const VectorRegister4Double UnitY = VectorSelect(VectorCompareGT(LengthSquaredY, MinScaleSquared), VectorMultiply(AxisY, VectorReciprocalSqrt(LengthSquaredY)), VectorZeroDouble());
+		const VectorRegister4Double UnitZ = VectorSelect(VectorCompareGT(LengthSquaredZ, MinScaleSquared), VectorMultiply(AxisZ, VectorReciprocalSqrt(LengthSquaredZ)), VectorZeroDouble());
 
-	for (int i = 0; i < PropertyCount; ++i)
+		double ScaleX = FMath::Sqrt(VectorGetComponent(LengthSquaredX, 0));
+
+		// A mirrored transform has a negative determinant, the reflection goes on the X scale as FTransform(FMatrix) does,
+		// which leaves proper axes for the rotation extraction
+		if (VectorGetComponent(VectorDot3(VectorCross(AxisX, AxisY), AxisZ), 0) < 0.0)
+		{
+			ScaleX = -ScaleX;
+			UnitX = VectorNegate(UnitX);
+		}
+
+		const VectorRegister4Double Scale = MakeVectorRegisterDouble(ScaleX, FMath::Sqrt(VectorGetComponent(LengthSquaredY, 0)), FMath::Sqrt(VectorGetComponent(LengthSquaredZ, 0)), 0.0);
+
+		// Rotation from the orthonormal axes, same branches as FQuat(const FMatrix&)
+		double M[3][4];
+		VectorStore(UnitX, M[0]);
+		VectorStore(UnitY, M[1]);
+		VectorStore(UnitZ, M[2]);
+
+		double Quat[4];
+		const double Trace = M[0][0] + M[1][1] + M[2][2];
+		if (Trace > 0.0)
+		{
+			const double InvS = FMath::InvSqrt(Trace + 1.0);
+			const double S = 0.5 * InvS;
+			Quat[0] = (M[1][2] - M[2][1]) * S;
+			Quat[1] = (M[2][0] - M[0][2]) * S;
+			Quat[2] = (M[0][1] - M[1][0]) * S;
+			Quat[3] = 0.5 / InvS;
+		}
+		else
+		{
+			int32 I = 0;
+			if (M[1][1] > M[0][0])
+			{
+				I = 1;
+			}
+			if (M[2][2] > M[I][I])
+			{
+				I = 2;
+			}
+
+			static const int32 Next[3] = { 1, 2, 0 };
+			const int32 J = Next[I];
+			const int32 K = Next[J];
+
+			const double InvS = FMath::InvSqrt(FMath::Max(M[I][I] - M[J][J] - M[K][K] + 1.0, UE_SMALL_NUMBER));
+			const double S = 0.5 * InvS;
+			Quat[I] = 0.5 / InvS;
+			Quat[J] = (M[I][J] + M[J][I]) * S;
+			Quat[K] = (M[I][K] + M[K][I]) * S;
+			Quat[3] = (M[J][K] - M[K][J]) * S;
+		}
+
+		const VectorRegister4Double Rotation = VectorNormalizeSafe(VectorLoad(Quat), GlobalVectorConstants::Double0001);
+		OutTransforms[Index] = FTransform(Rotation, Translation, Scale);
+	}
+}
+
+template FTransform MobuUtilities::ConvertTransform<MobuCoordinateSystem::FUnrealSpace>(FBMatrix);
+template FTransform MobuUtilities::ConvertTransform<MobuCoordinateSystem::FUnrealCameraSpace>(FBMatrix);
+template FTransform MobuUtilities::ConvertTransform<MobuCoordinateSystem::FUnrealLocalSpace>(FBMatrix);
+template void MobuUtilities::ConvertTransforms<MobuCoordinateSystem::FUnrealSpace>(const FBMatrix*, int32, FTransform*);
+template void MobuUtilities::ConvertTransforms<MobuCoordinateSystem::FUnrealCameraSpace>(const FBMatrix*, int32, FTransform*);
+template void MobuUtilities::ConvertTransforms<MobuCoordinateSystem::FUnrealLocalSpace>(const FBMatrix*, int32, FTransform*);
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	// Both paths run in double precision, only the rotation extraction order differs
+	const double TransformConversionTolerance = 1.e-4;
+
+	template<typename SpacePolicy>
+	int32 CountConversionMismatches(const TArray<FBMatrix>& Samples, const char* SpaceName)
 	{
-		FBProperty* Property = MobuModel->PropertyList[i];
-		if (Property->IsAnimatable())
+		TArray<FTransform> Converted;
+		Converted.SetNum(Samples.Num());
+		MobuUtilities::ConvertTransforms<SpacePolicy>(Samples.GetData(), Samples.Num(), Converted.GetData());
+
+		int32 Mismatches = 0;
+		for (int32 SampleIndex = 0; SampleIndex < Samples.Num(); ++SampleIndex)
 		{
-			//Only add supported property
-			switch (Property->GetPropertyType())
+			const FTransform Reference = MobuUtilities::ConvertTransform<SpacePolicy>(Samples[SampleIndex]);
+			if (!Reference.Equals(Converted[SampleIndex], TransformConversionTolerance))
 			{
-			case kFBPT_bool:
-			case kFBPT_double:
-			case kFBPT_float:
-			case kFBPT_enum:
-			case kFBPT_int:
-			case kFBPT_int64:
-			case kFBPT_uint64:
-				break;
-			default:
-				continue;
+				FBTrace("MobuLiveLink %s transform conversion disagrees with the scalar path on sample %d\n", SpaceName, SampleIndex);
+				++Mismatches;
 			}
+		}
+		return Mismatches;
+	}
+
+	// MobuTransformToUnreal on a Y-Up corrected matrix, as the world path converted before the coordinate system policies
+	FTransform BaselineUnrealTransform(const FBMatrix& MobuTransform)
+	{
+		FBMatrix MatOffset;
+		FBMatrix CorrectedTransform;
+		FBRVector RotOffset(90, 0, 0);
+		FBRotationToMatrix(MatOffset, RotOffset);
+		FBMatrixMult(CorrectedTransform, MatOffset, MobuTransform);
 
-			if (!Prefix.IsEmpty())
+		FBMatrix MobuTransformUnrealSpace;
+		FBTVector TVector;
+		FBSVector SVector;
+		FBQuaternion Quat;
+		for (int j = 0; j < 4; ++j)
+		{
+			if (j == 1)
 			{
-				LiveLinkCurves.Add(*(Prefix + FString(":") + Property->GetName()));
+				MobuTransformUnrealSpace(j, 0) = -CorrectedTransform(j, 0);
+				MobuTransformUnrealSpace(j, 1) = CorrectedTransform(j, 1);
+				MobuTransformUnrealSpace(j, 2) = -CorrectedTransform(j, 2);
+				MobuTransformUnrealSpace(j, 3) = -CorrectedTransform(j, 3);
 			}
 			else
 			{
-				LiveLinkCurves.Add(Property->GetName());
+				MobuTransformUnrealSpace(j, 0) = CorrectedTransform(j, 0);
+				MobuTransformUnrealSpace(j, 1) = -CorrectedTransform(j, 1);
+				MobuTransformUnrealSpace(j, 2) = CorrectedTransform(j, 2);
+				MobuTransformUnrealSpace(j, 3) = CorrectedTransform(j, 3);
 			}
 		}
+
+		FBMatrixToTranslation(TVector, MobuTransformUnrealSpace);
+		FBMatrixToQuaternion(Quat, MobuTransformUnrealSpace);
+		FBMatrixToScaling(SVector, MobuTransformUnrealSpace);
+
+		FTransform UnrealTransform;
+		UnrealTransform.SetRotation(FQuat(Quat[0], Quat[1], Quat[2], Quat[3]));
+		UnrealTransform.SetTranslation(FVector(TVector[0], TVector[1], TVector[2]));
+		UnrealTransform.SetScale3D(FVector(SVector[0], SVector[1], SVector[2]));
+		return UnrealTransform;
+	}
+
+	// FixCameraRotation as the camera stream object applied it on top of the world path
+	FTransform BaselineUnrealCameraTransform(const FBMatrix& MobuTransform)
+	{
+		FTransform Transform = BaselineUnrealTransform(MobuTransform);
+
+		const FMatrix InMatrix = Transform.ToMatrixWithScale();
+		const FVector DestX = InMatrix.GetScaledAxis(EAxis::X);
+		const FVector DestY = InMatrix.GetScaledAxis(EAxis::Z);
+		const FVector DestZ = InMatrix.GetScaledAxis(EAxis::Y) * -1;
+
+		FMatrix ResultMatrix(InMatrix);
+		ResultMatrix.SetAxes(&DestX, &DestY, &DestZ);
+		Transform.SetFromMatrix(ResultMatrix);
+		return Transform;
+	}
+
+	// Compared as matrices, the baseline may split a rotation and scale differently for the same transform
+	template<typename SpacePolicy>
+	int32 CountBaselineMismatches(TArrayView<const FBMatrix> Samples, TArrayView<const FTransform> Baselines, const char* SpaceName)
+	{
+		TArray<FTransform> Converted;
+		Converted.SetNum(Samples.Num());
+		MobuUtilities::ConvertTransforms<SpacePolicy>(Samples.GetData(), Samples.Num(), Converted.GetData());
+
+		int32 Mismatches = 0;
+		for (int32 SampleIndex = 0; SampleIndex < Samples.Num(); ++SampleIndex)
+		{
+			const FMatrix Baseline = Baselines[SampleIndex].ToMatrixWithScale();
+			const bool bScalarMatches = MobuUtilities::ConvertTransform<SpacePolicy>(Samples[SampleIndex]).ToMatrixWithScale().Equals(Baseline, TransformConversionTolerance);
+			const bool bBatchMatches = Converted[SampleIndex].ToMatrixWithScale().Equals(Baseline, TransformConversionTolerance);
+			if (!bScalarMatches || !bBatchMatches)
+			{
+				FBTrace("MobuLiveLink %s transform conversion disagrees with the baseline conversion on sample %d\n", SpaceName, SampleIndex);
+				++Mismatches;
+			}
+		}
+		return Mismatches;
 	}
-	return LiveLinkCurves;
 }
 
-TArray<float> MobuUtilities::GetAllAnimatableCurveValues(FBModel* MobuModel)
+bool MobuUtilities::CheckTransformConversions()
 {
-	int PropertyCount = MobuModel->PropertyList.GetCount();
+	TArray<FBMatrix> Samples;
+	auto AddSample = [&Samples](const FBVector4d& Translation, const FBVector3d& Rotation, const FBSVector& Scaling)
+	{
+		FBMatrix Sample;
+		FBTRSToMatrix(Sample, Translation, Rotation, Scaling);
+		Samples.Add(Sample);
+	};
 
-	TArray<float> LiveLinkCurves;
-	// Reserve enough memory for worst case
-	LiveLinkCurves.Reserve(PropertyCount);
+	AddSample(FBVector4d(0.0, 0.0, 0.0, 1.0), FBVector3d(0.0, 0.0, 0.0), FBSVector(1.0, 1.0, 1.0));
+	AddSample(FBVector4d(10.0, -20.0, 30.0, 1.0), FBVector3d(30.0, 45.0, 60.0), FBSVector(1.0, 1.0, 1.0));
+	AddSample(FBVector4d(-5.0, 2.5, 100.0, 1.0), FBVector3d(-120.0, 15.0, 80.0), FBSVector(2.0, 0.5, 3.0));
 
-	float PropertyValue;
-	for (int i = 0; i < PropertyCount; ++i)
+	// Half turns take the branches of the rotation extraction that do not start from the trace
+	AddSample(FBVector4d(1.0, 2.0, 3.0, 1.0), FBVector3d(180.0, 0.0, 0.0), FBSVector(1.0, 1.0, 1.0));
+	AddSample(FBVector4d(0.0, 0.0, 0.0, 1.0), FBVector3d(0.0, 180.0, 0.0), FBSVector(1.0, 1.0, 1.0));
+	AddSample(FBVector4d(0.0, 0.0, 0.0, 1.0), FBVector3d(0.0, 0.0, 179.0), FBSVector(4.0, 4.0, 4.0));
+
+	// The baseline extracted rotations with FBMatrixToQuaternion, which only holds for transforms that are not mirrored
+	const int32 BaselineSampleCount = Samples.Num();
+
+	// Mirrored, the reflection has to come out on the X scale whichever axis carried it
+	AddSample(FBVector4d(3.0, -7.0, 12.0, 1.0), FBVector3d(20.0, -35.0, 110.0), FBSVector(-1.0, 1.0, 1.0));
+	AddSample(FBVector4d(0.0, 5.0, 0.0, 1.0), FBVector3d(90.0, 0.0, 45.0), FBSVector(1.5, -2.0, 0.5));
+	AddSample(FBVector4d(-8.0, 0.0, 4.0, 1.0), FBVector3d(0.0, 170.0, -60.0), FBSVector(-1.0, -1.0, -1.0));
+
+	int32 Mismatches = CountConversionMismatches<MobuCoordinateSystem::FUnrealSpace>(Samples, "Unreal space")
+		+ CountConversionMismatches<MobuCoordinateSystem::FUnrealCameraSpace>(Samples, "Unreal camera space")
+		+ CountConversionMismatches<MobuCoordinateSystem::FUnrealLocalSpace>(Samples, "Unreal local space");
+
+	const TArrayView<const FBMatrix> BaselineSamples(Samples.GetData(), BaselineSampleCount);
+	TArray<FTransform> WorldBaselines;
+	TArray<FTransform> CameraBaselines;
+	for (const FBMatrix& Sample : BaselineSamples)
 	{
-		FBProperty* Property = MobuModel->PropertyList[i];
-		if (Property->IsAnimatable())
+		WorldBaselines.Add(BaselineUnrealTransform(Sample));
+		CameraBaselines.Add(BaselineUnrealCameraTransform(Sample));
+	}
+
+	// The baseline made each global bone transform relative to its parent's, parents keep a uniform scale an FTransform can hold
+	TArray<FBMatrix> LocalSamples;
+	TArray<FTransform> LocalBaselines;
+	auto AddLocalSample = [&LocalSamples, &LocalBaselines](const FBVector4d& ParentTranslation, const FBVector3d& ParentRotation, double ParentScaling,
+		const FBVector4d& Translation, const FBVector3d& Rotation, const FBSVector& Scaling)
+	{
+		FBMatrix Parent;
+		FBMatrix Local;
+		FBMatrix Global;
+		FBTRSToMatrix(Parent, ParentTranslation, ParentRotation, FBSVector(ParentScaling, ParentScaling, ParentScaling));
+		FBTRSToMatrix(Local, Translation, Rotation, Scaling);
+		FBGetGlobalMatrix(Global, Parent, Local);
+
+		LocalSamples.Add(Local);
+		LocalBaselines.Add(BaselineUnrealTransform(Global) * BaselineUnrealTransform(Parent).Inverse());
+	};
+
+	AddLocalSample(FBVector4d(0.0, 0.0, 0.0, 1.0), FBVector3d(0.0, 0.0, 0.0), 1.0, FBVector4d(0.0, 10.0, 0.0, 1.0), FBVector3d(0.0, 0.0, 0.0), FBSVector(1.0, 1.0, 1.0));
+	AddLocalSample(FBVector4d(10.0, 95.0, -4.0, 1.0), FBVector3d(-90.0, 0.0, 90.0), 1.0, FBVector4d(12.0, 0.0, 1.5, 1.0), FBVector3d(15.0, -30.0, 45.0), FBSVector(1.0, 1.0, 1.0));
+	AddLocalSample(FBVector4d(-3.0, 40.0, 7.0, 1.0), FBVector3d(25.0, 60.0, -110.0), 2.0, FBVector4d(5.0, -5.0, 20.0, 1.0), FBVector3d(170.0, 10.0, 0.0), FBSVector(0.5, 1.5, 3.0));
+	AddLocalSample(FBVector4d(0.0, 0.0, 100.0, 1.0), FBVector3d(0.0, 180.0, 0.0), 0.5, FBVector4d(0.0, 0.0, -8.0, 1.0), FBVector3d(0.0, 0.0, 180.0), FBSVector(2.0, 2.0, 2.0));
+
+	Mismatches += CountBaselineMismatches<MobuCoordinateSystem::FUnrealSpace>(BaselineSamples, WorldBaselines, "Unreal space")
+		+ CountBaselineMismatches<MobuCoordinateSystem::FUnrealCameraSpace>(BaselineSamples, CameraBaselines, "Unreal camera space")
+		+ CountBaselineMismatches<MobuCoordinateSystem::FUnrealLocalSpace>(LocalSamples, LocalBaselines, "Unreal local space");
+	return Mismatches == 0;
+}
+
+namespace
+{
+	// Stands in for GMalloc while a counter is live, forwards everything to the allocator it replaced
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+		FMalloc* Inner = nullptr;
+		std::atomic<uint32> CountingThreadId{ 0 };
+		int32 ExclusionDepth = 0; //!< Only touched by the counting thread
+		int32 AllocationCount = 0; //!< Only touched by the counting thread
+
+		bool IsCountingThread() const
 		{
-			switch (Property->GetPropertyType())
-			{
-			case kFBPT_bool:
+			return FPlatformTLS::GetCurrentThreadId() == CountingThreadId.load(std::memory_order_relaxed);
+		}
+
+		void CountAllocation()
+		{
+			if (IsCountingThread() && ExclusionDepth == 0)
 			{
-				bool bValue;
-				Property->GetData(&bValue, sizeof(bValue), nullptr);
-				PropertyValue = bValue ? 1.0f : 0.0f;
-				break;
+				++AllocationCount;
 			}
-			case kFBPT_double:
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
 			{
-				double Value;
-				Property->GetData(&Value, sizeof(Value), nullptr);
-				PropertyValue = (float)Value;
-				break;
+				CountAllocation();
 			}
-			case kFBPT_float:
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
 			{
-				// PropertyValue is a float so retrieve it directly
-				Property->GetData(&PropertyValue, sizeof(PropertyValue), nullptr);
-				break;
+				CountAllocation();
 			}
-			case kFBPT_enum: // Enums are assumed to be ints
-			case kFBPT_int:
+			return Inner->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			Inner->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return Inner->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return Inner->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return Inner->IsInternallyThreadSafe();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return Inner->GetDescriptiveName();
+		}
+	};
+
+	// Never destroyed, another thread may still be inside it when GMalloc is put back
+	FCountingMalloc CountingMalloc;
+}
+
+MobuUtilities::FScopedAllocationCounter::FScopedAllocationCounter()
+{
+	check(CountingMalloc.Inner == nullptr);
+	CountingMalloc.AllocationCount = 0;
+	CountingMalloc.ExclusionDepth = 0;
+	CountingMalloc.CountingThreadId.store(FPlatformTLS::GetCurrentThreadId(), std::memory_order_relaxed);
+	CountingMalloc.Inner = GMalloc;
+	GMalloc = &CountingMalloc;
+}
+
+MobuUtilities::FScopedAllocationCounter::~FScopedAllocationCounter()
+{
+	GMalloc = CountingMalloc.Inner;
+	CountingMalloc.CountingThreadId.store(0, std::memory_order_relaxed);
+	CountingMalloc.Inner = nullptr;
+}
+
+int32 MobuUtilities::FScopedAllocationCounter::GetCount() const
+{
+	return CountingMalloc.AllocationCount;
+}
+
+MobuUtilities::FScopedAllocationCounterExclusion::FScopedAllocationCounterExclusion()
+{
+	if (CountingMalloc.IsCountingThread())
+	{
+		++CountingMalloc.ExclusionDepth;
+	}
+}
+
+MobuUtilities::FScopedAllocationCounterExclusion::~FScopedAllocationCounterExclusion()
+{
+	if (CountingMalloc.IsCountingThread())
+	{
+		--CountingMalloc.ExclusionDepth;
+	}
+}
+#endif
+
+void MobuUtilities::GetModelMatrix(FBModel* MobuModel, FBMatrix& OutTransform, bool bIsGlobal, FBEvaluateInfo* EvaluateInfo)
+{
+	MobuModel->GetMatrix(OutTransform, kModelTransformation, bIsGlobal, EvaluateInfo);
+}
+
+FTransform MobuUtilities::UnrealTransformFromModel(FBModel* MobuModel, bool bIsGlobal, FBEvaluateInfo* EvaluateInfo)
+{
+	FBMatrix MobuTransform;
+	GetModelMatrix(MobuModel, MobuTransform, bIsGlobal, EvaluateInfo);
+
+	FTransform UnrealTransform;
+	ConvertTransforms<MobuCoordinateSystem::FUnrealSpace>(&MobuTransform, 1, &UnrealTransform);
+	return UnrealTransform;
+};
+
+FTransform MobuUtilities::UnrealCameraTransformFromModel(FBModel* MobuModel, bool bIsGlobal, FBEvaluateInfo* EvaluateInfo)
+{
+	FBMatrix MobuTransform;
+	GetModelMatrix(MobuModel, MobuTransform, bIsGlobal, EvaluateInfo);
+
+	FTransform UnrealTransform;
+	ConvertTransforms<MobuCoordinateSystem::FUnrealCameraSpace>(&MobuTransform, 1, &UnrealTransform);
+	return UnrealTransform;
+}
+
+void FMobuAnimatableCurveTable::Reset()
+{
+	Accessors.Reset();
+}
+
+void FMobuAnimatableCurveTable::AddModel(FBModel* MobuModel, const FString& Prefix, TArray<FName>& OutNames)
+{
+	const int PropertyCount = MobuModel->PropertyList.GetCount();
+
+	for (int i = 0; i < PropertyCount; ++i)
+	{
+		FBProperty* Property = MobuModel->PropertyList[i];
+		if (!Property->IsAnimatable())
+		{
+			continue;
+		}
+
+		//Only add supported property
+		const FBPropertyType PropertyType = Property->GetPropertyType();
+		switch (PropertyType)
+		{
+		case kFBPT_bool:
+		case kFBPT_double:
+		case kFBPT_float:
+		case kFBPT_enum:
+		case kFBPT_int:
+		case kFBPT_int64:
+		case kFBPT_uint64:
+			break;
+		default:
+			continue;
+		}
+
+		Accessors.Add({ Property, PropertyType, Accessors.Num() });
+
+		if (!Prefix.IsEmpty())
+		{
+			OutNames.Add(*(Prefix + FString(":") + Property->GetName()));
+		}
+		else
+		{
+			OutNames.Add(Property->GetName());
+		}
+	}
+}
+
+void FMobuAnimatableCurveTable::Sample(FBEvaluateInfo* EvaluateInfo, TArray<float>& OutValues) const
+{
+	OutValues.SetNumUninitialized(Accessors.Num(), false);
+	float* Values = OutValues.GetData();
+
+	for (const FAccessor& Accessor : Accessors)
+	{
+		float& PropertyValue = Values[Accessor.Offset];
+		switch (Accessor.Type)
+		{
+		case kFBPT_bool:
+		{
+			bool bValue;
+			Accessor.Property->GetData(&bValue, sizeof(bValue), EvaluateInfo);
+			PropertyValue = bValue ? 1.0f : 0.0f;
+			break;
+		}
+		case kFBPT_double:
+		{
+			double Value;
+			Accessor.Property->GetData(&Value, sizeof(Value), EvaluateInfo);
+			PropertyValue = (float)Value;
+			break;
+		}
+		case kFBPT_float:
+		{
+			// PropertyValue is a float so retrieve it directly
+			Accessor.Property->GetData(&PropertyValue, sizeof(PropertyValue), EvaluateInfo);
+			break;
+		}
+		case kFBPT_enum: // Enums are assumed to be ints
+		case kFBPT_int:
+		{
+			int Value;
+			Accessor.Property->GetData(&Value, sizeof(Value), EvaluateInfo);
+			PropertyValue = (float)Value;
+			break;
+		}
+		case kFBPT_int64:
+		{
+			int64 Value;
+			Accessor.Property->GetData(&Value, sizeof(Value), EvaluateInfo);
+			PropertyValue = (float)Value;
+			break;
+		}
+		case kFBPT_uint64:
+		{
+			uint64 Value;
+			Accessor.Property->GetData(&Value, sizeof(Value), EvaluateInfo);
+			PropertyValue = (float)Value;
+			break;
+		}
+		default:
+			checkNoEntry();
+			break;
+		}
+	}
+}
+
+bool FMobuFlatHierarchy::IsIncluded(FBModel* Model, EFilter Filter)
+{
+	if (Filter == EFilter::JointsOnly)
+	{
+		const int ModelType = Model->GetTypeId();
+		return ModelType == FBModelSkeleton::TypeInfo || ModelType == FBModelRoot::TypeInfo;
+	}
+	return true;
+}
+
+uint32 FMobuFlatHierarchy::HashNode(const FBModel* Model)
+{
+	return HashCombine(GetTypeHash(Model), FCrc::StrCrc32((const char*)Model->Name));
+}
+
+void FMobuFlatHierarchy::Reset()
+{
+	Models.Reset();
+	Parents.Reset();
+	Names.Reset();
+	HasChildren.Reset();
+	NodeHashes.Reset();
+	ModelToIndex.Reset();
+	BuiltRoot = nullptr;
+}
+
+bool FMobuFlatHierarchy::Update(const FBModel* RootModel, EFilter Filter)
+{
+	// Cheaper than a build: no arrays are filled and no names are interned
+	int32 SceneCount = 0;
+	const uint32 Signature = ComputeSignature(RootModel, Filter, SceneCount);
+	if (BuiltRoot == RootModel && BuiltFilter == Filter && BuiltSignature == Signature && Models.Num() == SceneCount)
+	{
+		return false;
+	}
+
+	Build(RootModel, Filter);
+	BuiltRoot = RootModel;
+	BuiltFilter = Filter;
+	BuiltSignature = Signature;
+	return true;
+}
+
+bool FMobuFlatHierarchy::ApplyEdits(const TArray<FEdit>& Edits)
+{
+	if (BuiltRoot == nullptr)
+	{
+		// Nothing streamed yet, the next Update() walks the scene anyway
+		return false;
+	}
+
+	bool bChanged = false;
+	for (const FEdit& Edit : Edits)
+	{
+		// A model destroyed later in the batch can no longer be read
+		const bool bDestroyed = Edit.bDestroyed || Edits.ContainsByPredicate([&Edit](const FEdit& Other) { return Other.Model == Edit.Model && Other.bDestroyed; });
+		bChanged |= bDestroyed ? DetachModel(Edit.Model) : ReparentModel(Edit.Model, BuiltFilter);
+	}
+
+	if (!bChanged)
+	{
+		return false;
+	}
+
+	// We only patched the models we were told about, anything else that changed needs a full walk
+	int32 SceneCount = 0;
+	const uint32 Signature = ComputeSignature(BuiltRoot, BuiltFilter, SceneCount);
+	if (SceneCount != Models.Num() || !MatchesScene(BuiltRoot, BuiltFilter))
+	{
+		Build(BuiltRoot, BuiltFilter);
+	}
+#if !UE_BUILD_SHIPPING
+	else
+	{
+		// Patched arrays have to hold what a build from scratch would, in whatever order
+		FMobuFlatHierarchy FreshHierarchy;
+		FreshHierarchy.Build(BuiltRoot, BuiltFilter);
+
+		bool bMatchesBuild = true;
+		for (int32 FreshIndex = 0; FreshIndex < FreshHierarchy.Num() && bMatchesBuild; ++FreshIndex)
+		{
+			const int32* Index = ModelToIndex.Find(FreshHierarchy.Models[FreshIndex]);
+			const int32 FreshParent = FreshHierarchy.Parents[FreshIndex];
+			bMatchesBuild = Index != nullptr
+				&& Names[*Index] == FreshHierarchy.Names[FreshIndex]
+				&& HasChildren[*Index] == FreshHierarchy.HasChildren[FreshIndex]
+				&& (FreshParent == -1 ? Parents[*Index] == -1 : Parents[*Index] != -1 && Models[Parents[*Index]] == FreshHierarchy.Models[FreshParent]);
+		}
+		ensureMsgf(bMatchesBuild && FreshHierarchy.Num() == Num(), TEXT("MobuLiveLink patched hierarchy differs from a fresh build"));
+	}
+#endif
+	BuiltSignature = Signature;
+	return true;
+}
+
+uint32 FMobuFlatHierarchy::ComputeSignature(const FBModel* RootModel, EFilter Filter, int32& OutCount)
+{
+	uint32 Signature = 0;
+
+	// Breadth first like a build, moving or swapping nodes changes the signature even when the set of models does not
+	WalkQueue.Reset();
+	WalkQueue.Emplace(const_cast<FBModel*>(RootModel), -1);
+	for (int32 WalkIndex = 0; WalkIndex < WalkQueue.Num(); ++WalkIndex)
+	{
+		FBModel* Model = WalkQueue[WalkIndex].Key;
+		Signature = HashCombine(Signature, HashCombine(HashNode(Model), GetTypeHash(WalkQueue[WalkIndex].Value)));
+
+		const int ChildCount = Model->Children.GetCount();
+		for (int ChildIndex = 0; ChildIndex < ChildCount; ++ChildIndex)
+		{
+			FBModel* ChildModel = Model->Children[ChildIndex];
+			if (IsIncluded(ChildModel, Filter))
 			{
-				int Value;
-				Property->GetData(&Value, sizeof(Value), nullptr);
-				PropertyValue = (float)Value;
-				break;
+				WalkQueue.Emplace(ChildModel, WalkIndex);
 			}
-			case kFBPT_int64:
+		}
+	}
+
+	OutCount = WalkQueue.Num();
+	return Signature;
+}
+
+bool FMobuFlatHierarchy::MatchesScene(const FBModel* RootModel, EFilter Filter)
+{
+	WalkQueue.Reset();
+	WalkQueue.Emplace(const_cast<FBModel*>(RootModel), -1);
+	for (int32 WalkIndex = 0; WalkIndex < WalkQueue.Num(); ++WalkIndex)
+	{
+		FBModel* Model = WalkQueue[WalkIndex].Key;
+		const int32* Index = ModelToIndex.Find(Model);
+		if (Index == nullptr || NodeHashes[*Index] != HashNode(Model))
+		{
+			return false;
+		}
+
+		// The parent was walked and found before its children
+		const int32 ParentWalkIndex = WalkQueue[WalkIndex].Value;
+		const int32 ExpectedParent = ParentWalkIndex != -1 ? ModelToIndex.FindChecked(WalkQueue[ParentWalkIndex].Key) : -1;
+		if (Parents[*Index] != ExpectedParent)
+		{
+			return false;
+		}
+
+		const int ChildCount = Model->Children.GetCount();
+		for (int ChildIndex = 0; ChildIndex < ChildCount; ++ChildIndex)
+		{
+			FBModel* ChildModel = Model->Children[ChildIndex];
+			if (IsIncluded(ChildModel, Filter))
 			{
-				int64 Value;
-				Property->GetData(&Value, sizeof(Value), nullptr);
-				PropertyValue = (float)Value;
-				break;
+				WalkQueue.Emplace(ChildModel, WalkIndex);
 			}
-			case kFBPT_uint64:
+		}
+	}
+
+	// Every model found once, a count match leaves no model of ours outside of the scene
+	return WalkQueue.Num() == Models.Num();
+}
+
+void FMobuFlatHierarchy::AddNode(const FBModel* Model, int32 ParentIndex)
+{
+	ModelToIndex.Add(Model, Models.Num());
+	NodeHashes.Add(HashNode(Model));
+	Models.Add(Model);
+	Parents.Add(ParentIndex);
+	Names.Emplace(Model->Name);
+}
+
+void FMobuFlatHierarchy::UpdateHasChildren()
+{
+	HasChildren.Init(false, Models.Num());
+	for (int32 ParentIndex : Parents)
+	{
+		if (ParentIndex != -1)
+		{
+			HasChildren[ParentIndex] = true;
+		}
+	}
+}
+
+void FMobuFlatHierarchy::Build(const FBModel* RootModel, EFilter Filter)
+{
+	Models.Reset();
+	Parents.Reset();
+	Names.Reset();
+	NodeHashes.Reset();
+	ModelToIndex.Reset();
+
+	AddNode(RootModel, -1);
+
+	// The flattened arrays are their own breadth first queue, every parent is visited before its children are appended
+	for (int32 ParentIndex = 0; ParentIndex < Models.Num(); ++ParentIndex)
+	{
+		FBModel* ParentModel = const_cast<FBModel*>(Models[ParentIndex]);
+		const int ChildCount = ParentModel->Children.GetCount();
+		for (int ChildIndex = 0; ChildIndex < ChildCount; ++ChildIndex)
+		{
+			FBModel* ChildModel = ParentModel->Children[ChildIndex];
+			if (IsIncluded(ChildModel, Filter))
 			{
-				uint64 Value;
-				Property->GetData(&Value, sizeof(Value), nullptr);
-				PropertyValue = (float)Value;
-				break;
+				AddNode(ChildModel, ParentIndex);
 			}
-			default:
-				continue;
+		}
+	}
+
+	UpdateHasChildren();
+}
+
+bool FMobuFlatHierarchy::DetachModel(const FBModel* Model)
+{
+	const int32* FoundIndex = ModelToIndex.Find(Model);
+	if (FoundIndex == nullptr || *FoundIndex == 0)
+	{
+		// Not ours, or the root which is never detached from its own hierarchy
+		return false;
+	}
+
+	// Parents come first, so a single pass sees every removed parent before its children
+	const int32 DetachedIndex = *FoundIndex;
+	const int32 OldCount = Models.Num();
+	Remap.SetNumUninitialized(OldCount, false);
+
+	int32 NewCount = 0;
+	for (int32 Index = 0; Index < OldCount; ++Index)
+	{
+		const int32 OldParent = Parents[Index];
+		if (Index == DetachedIndex || (OldParent != -1 && Remap[OldParent] == INDEX_NONE))
+		{
+			Remap[Index] = INDEX_NONE;
+			ModelToIndex.Remove(Models[Index]);
+			continue;
+		}
+
+		Remap[Index] = NewCount;
+		if (NewCount != Index)
+		{
+			Models[NewCount] = Models[Index];
+			Names[NewCount] = Names[Index];
+			NodeHashes[NewCount] = NodeHashes[Index];
+			ModelToIndex[Models[NewCount]] = NewCount;
+		}
+		Parents[NewCount] = OldParent != -1 ? Remap[OldParent] : -1;
+		++NewCount;
+	}
+
+	Models.SetNum(NewCount, false);
+	Parents.SetNum(NewCount, false);
+	Names.SetNum(NewCount, false);
+	NodeHashes.SetNum(NewCount, false);
+	UpdateHasChildren();
+	return true;
+}
+
+bool FMobuFlatHierarchy::ReparentModel(const FBModel* Model, EFilter Filter)
+{
+	FBModel* NewParent = const_cast<FBModel*>(Model)->Parent;
+
+	bool bChanged = false;
+	if (const int32* Index = ModelToIndex.Find(Model))
+	{
+		if (*Index == 0 || Models[Parents[*Index]] == NewParent)
+		{
+			// Attached again where we already have it, or a connection that is not a parent change
+			return false;
+		}
+		bChanged = DetachModel(Model);
+	}
+
+	const int32* ParentIndex = NewParent ? ModelToIndex.Find(NewParent) : nullptr;
+	if (ParentIndex == nullptr || !IsIncluded(const_cast<FBModel*>(Model), Filter))
+	{
+		return bChanged;
+	}
+
+	// Append the subtree after every existing model, the same breadth first walk as a build
+	const int32 FirstIndex = Models.Num();
+	AddNode(Model, *ParentIndex);
+	for (int32 Index = FirstIndex; Index < Models.Num(); ++Index)
+	{
+		FBModel* SubtreeModel = const_cast<FBModel*>(Models[Index]);
+		const int ChildCount = SubtreeModel->Children.GetCount();
+		for (int ChildIndex = 0; ChildIndex < ChildCount; ++ChildIndex)
+		{
+			FBModel* ChildModel = SubtreeModel->Children[ChildIndex];
+			if (IsIncluded(ChildModel, Filter))
+			{
+				AddNode(ChildModel, Index);
 			}
-			LiveLinkCurves.Add(PropertyValue);
 		}
 	}
-	return LiveLinkCurves;
+
+	UpdateHasChildren();
+	return true;
+}
+
+void MobuUtilities::InitializeFrameData(FLiveLinkFrameDataStruct& FrameData, const UScriptStruct* Struct)
+{
+	if (FrameData.GetStruct() != Struct || !FrameData.IsValid())
+	{
+		FrameData.InitializeWith(Struct, nullptr);
+	}
+}
+
+void MobuUtilities::CopyFrameData(const FLiveLinkFrameDataStruct& Source, FLiveLinkFrameDataStruct& Dest)
+{
+	const UScriptStruct* Struct = Source.GetStruct();
+	InitializeFrameData(Dest, Struct);
+	Struct->CopyScriptStruct(Dest.GetBaseData(), Source.GetBaseData());
+}
+
+namespace
+{
+	// Saving archive that folds the bytes into a CRC as they are written, nothing is buffered
+	class FCrcWriter : public FArchive
+	{
+	public:
+		explicit FCrcWriter(uint32 InCrc)
+			: Crc(InCrc)
+		{
+			SetIsSaving(true);
+		}
+
+		virtual void Serialize(void* Data, int64 Num) override
+		{
+			Crc = FCrc::MemCrc32(Data, (int32)Num, Crc);
+		}
+
+		// Names hash by value, the hash is only compared within the session
+		virtual FArchive& operator<<(FName& Name) override
+		{
+			uint32 NameHash = GetTypeHash(Name);
+			Serialize(&NameHash, sizeof(NameHash));
+			return *this;
+		}
+
+		uint32 GetCrc() const { return Crc; }
+
+	private:
+		uint32 Crc;
+	};
+}
+
+uint32 MobuUtilities::HashStaticData(const UClass* Role, const FLiveLinkStaticDataStruct& StaticData)
+{
+	const UScriptStruct* Struct = StaticData.GetStruct();
+	uint32 Hash = HashCombine(GetTypeHash(Role), GetTypeHash(Struct));
+	if (Struct == nullptr || !StaticData.IsValid())
+	{
+		return Hash;
+	}
+
+	// Serialized straight into the CRC, the bytes only depend on the values and not on where they live
+	FCrcWriter Writer(Hash);
+	Struct->SerializeBin(Writer, const_cast<FLiveLinkBaseStaticData*>(StaticData.GetBaseData()));
+	return Writer.GetCrc();
+}
+
+uint32 MobuUtilities::HashFrameData(const FLiveLinkFrameDataStruct& FrameData)
+{
+	const UScriptStruct* Struct = FrameData.GetStruct();
+	const FLiveLinkBaseFrameData* BaseData = FrameData.GetBaseData();
+	if (Struct == nullptr || BaseData == nullptr)
+	{
+		return 0;
+	}
+
+	uint32 Hash = GetTypeHash(Struct);
+	auto HashValue = [&Hash](const auto& Value)
+	{
+		Hash = FCrc::MemCrc32(&Value, sizeof(Value), Hash);
+	};
+	auto HashArray = [&Hash](const auto& Values)
+	{
+		Hash = FCrc::MemCrc32(Values.GetData(), Values.Num() * Values.GetTypeSize(), Hash);
+	};
+
+	HashArray(BaseData->PropertyValues);
+
+	if (Struct->IsChildOf(FLiveLinkAnimationFrameData::StaticStruct()))
+	{
+		HashArray(static_cast<const FLiveLinkAnimationFrameData*>(BaseData)->Transforms);
+	}
+	else if (Struct->IsChildOf(FLiveLinkLocatorFrameData::StaticStruct()))
+	{
+		HashArray(static_cast<const FLiveLinkLocatorFrameData*>(BaseData)->Locators);
+	}
+	else if (Struct->IsChildOf(FLiveLinkTransformFrameData::StaticStruct()))
+	{
+		HashValue(static_cast<const FLiveLinkTransformFrameData*>(BaseData)->Transform);
+
+		if (Struct->IsChildOf(FLiveLinkCameraFrameData::StaticStruct()))
+		{
+			const FLiveLinkCameraFrameData* CameraData = static_cast<const FLiveLinkCameraFrameData*>(BaseData);
+			HashValue(CameraData->FieldOfView);
+			HashValue(CameraData->AspectRatio);
+			HashValue(CameraData->FocalLength);
+			HashValue(CameraData->Aperture);
+			HashValue(CameraData->FocusDistance);
+			HashValue(CameraData->ProjectionMode);
+		}
+		else if (Struct->IsChildOf(FLiveLinkLightFrameData::StaticStruct()))
+		{
+			const FLiveLinkLightFrameData* LightData = static_cast<const FLiveLinkLightFrameData*>(BaseData);
+			HashValue(LightData->Temperature);
+			HashValue(LightData->Intensity);
+			HashValue(LightData->LightColor);
+			HashValue(LightData->InnerConeAngle);
+			HashValue(LightData->OuterConeAngle);
+			HashValue(LightData->AttenuationRadius);
+			HashValue(LightData->SourceRadius);
+			HashValue(LightData->SoftSourceRadius);
+			HashValue(LightData->SourceLength);
+		}
+	}
+	return Hash;
 }
 
 FFrameRate MobuUtilities::TimeModeToFrameRate(FBTimeMode TimeMode)
@@ -213,58 +1025,4 @@ FFrameRate MobuUtilities::TimeModeToFrameRate(FBTimeMode TimeMode)
 	default:
 		return FFrameRate(FMath::RoundToInt(FBPlayerControl().GetTransportFpsValue() * 1001), 1001);
 	}
-}
-
-FQualifiedFrameTime MobuUtilities::GetSceneTimecode(ETimecodeMode TimecodeMode)
-{
-	FBTimeMode TimeMode = FBPlayerControl().GetTransportFps();
-	FFrameRate FrameRate = TimeModeToFrameRate(TimeMode);
-	FFrameTime FrameTime;
-
-	// Make sure we use the decimal frame time instead of the integer frame number to keep subframes
-	if (TimecodeMode == ETimecodeMode::TimecodeMode_Local)			// Local time (Take time)
-	{
-		FBTime MobuTime = FBSystem().LocalTime;
-		FrameTime = FFrameTime(FrameRate.AsFrameTime(MobuTime.GetSecondDouble()));
-	}
-	else if (TimecodeMode == ETimecodeMode::TimecodeMode_System)	// System time (PC clock)
-	{
-		const FDateTime DateTime = FDateTime::Now();
-		const FTimespan Timespan = DateTime.GetTimeOfDay();
-		FrameTime = FFrameTime(FrameRate.AsFrameTime(Timespan.GetTotalSeconds()));
-	}
-	else if (TimecodeMode == ETimecodeMode::TimecodeMode_Reference)	// Reference time (Incoming LTC)
-	{
-		FBReferenceTime MobuRefTime;
-		#if PRODUCT_VERSION >= 2019
-		FBArrayTemplate<int> Identifiers;
-		MobuRefTime.GetUniqueIDList(&Identifiers);
-		if (Identifiers.GetCount() > 0)
-		{
-			FBTime RefTime = MobuRefTime.GetTime(MobuRefTime.CurrentTimeReferenceID, FBTime(0));
-			FrameTime = FFrameTime(FrameRate.AsFrameTime(RefTime.GetSecondDouble()));
-		}
-		else
-		{
-			FBTrace("GetSceneTimecode - No Reference time sources\n");
-		}
-		#else
-		if (MobuRefTime.Count > 0)
-		{
-			FBTime RefTime = MobuRefTime.GetTime(MobuRefTime.ItemIndex, FBTime(0));
-			FrameTime = FFrameTime(FrameRate.AsFrameTime(RefTime.GetSecondDouble()));
-		}
-		else
-		{
-			FBTrace("GetSceneTimecode - No Reference time sources\n");
-		}
-		#endif
-		
-	}
-	else
-	{
-		FBTrace("GetSceneTimecode - Invalid timecode mode\n");
-	}
-
-	return FQualifiedFrameTime(FrameTime, FrameRate);
 }
\ No newline at end of file
@@ -2,7 +2,9 @@
 
 #pragma once
 
-#include "MobuLiveLinkCommon.h"
+#include "MobuLiveLinkUtilities.h"
+
+class FMobuDrivenModels;
 
 
 // Pure Abstract class. Inherit from this to support streaming.
@@ -33,15 +35,49 @@ public:
 
 	virtual void UpdateSendAnimatableStatus(bool bNewSendAnimatable) = 0;
 
+	// Read by the device scheduler on every update, only changes which updates sample the subject
+	virtual FStreamRateClass GetRateClass() const = 0;
+
+	virtual void UpdateRateClass(const FStreamRateClass& NewRateClass) = 0;
+
+	// Device wide setting, applied by the device to every object it streams
+	virtual void UpdateSkeletalSamplingSettings(const FSkeletalSamplingSettings& NewSettings) = 0;
+
+	// Gathered by the device for every object it streams, outlives them
+	virtual void UpdateDrivenModels(const FMobuDrivenModels* NewDrivenModels) = 0;
+
 	virtual const FBModel* GetModelPointer() const = 0;
 	
 	virtual const FString GetRootName() const = 0;
 
+	// O(1), tracked from scene events rather than searched for in the scene
 	virtual bool IsValid() const = 0;
 
-	// Interface for object streaming
+	// Called by the device when the root model is destroyed, detached from or attached back to the scene
+	virtual void NotifyRootInScene(bool bInScene) = 0;
+
+	// Whether UpdateSubjectFrame only reads its own models and can run on a worker thread alongside other objects
+	virtual bool CanUpdateInParallel() const = 0;
+
+	// Whether a change to this model can affect the subject's static data
+	virtual bool IsModelInHierarchy(const FBModel* Model) const = 0;
+
+	// Static data needs to be rebuilt. Marked from the UI thread, consumed by whichever thread refreshes
+	virtual void MarkDirty() = 0;
+	virtual bool IsDirty() const = 0;
+	virtual bool ConsumeDirty() = 0;
+
+	// A model was attached, detached or destroyed, recorded from the UI thread. Destroyed models are never read
+	virtual void NotifyHierarchyEdit(const FBModel* Model, bool bDestroyed) = 0;
+
+	// Called after ConsumeDirty() returned true, false if the static data we sent last is still up to date
+	virtual bool ApplyHierarchyEdits() = 0;
+
+	// Interface for object streaming, the device sends what the objects build
 
-	virtual void Refresh(const TSharedPtr<ILiveLinkProvider> Provider) = 0;
+	// Rebuild the subject's static data. Returns false if nothing should be sent
+	virtual bool Refresh(TSubclassOf<ULiveLinkRole>& OutRole, FLiveLinkStaticDataStruct& OutStaticData) = 0;
 
-	virtual void UpdateSubjectFrame(const TSharedPtr<ILiveLinkProvider> Provider, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime) = 0;
+	// Sample the subject's current frame. EvaluateInfo may be null outside of the device evaluation. Returns false if nothing should be sent
+	virtual bool UpdateSubjectFrame(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkFrameDataStruct& OutFrameData) = 0;
 };
\ No newline at end of file
@@ -4,6 +4,10 @@
 
 #include "MobuLiveLinkCommon.h"
 #include "MobuLiveLinkUtilities.h"
+#include "MobuLiveLinkSender.h"
+#include "MobuLiveLinkTimecode.h"
+#include "MobuLiveLinkStreamObjectRegistry.h"
+#include "MobuLiveLinkDrivenModels.h"
 #include "IStreamObject.h"
 #include "Misc/CommandLine.h"
 #include "Async/TaskGraphInterfaces.h"
@@ -11,6 +15,7 @@
 #include "UObject/Object.h"
 #include "Misc/ConfigCacheIni.h"
 #include "Misc/OutputDevice.h"
+#include "HAL/CriticalSection.h"
 
 //--- Registration defines
 #define MOBULIVELINK__CLASSNAME		FMobuLiveLink
@@ -51,22 +56,60 @@ public:
 
 	//--- Events
 	void EventSceneChange(HISender Sender, HKEvent Event);
+	void EventUIIdle(HISender Sender, HKEvent Event);
 	void EventRenderUpdate(HISender Sender, HKEvent Event);
+	void EventEvaluationUpdate(HISender Sender, HKEvent Event);
+
+	//--- Scripting, published so Python can reach them through the device PropertyList
+	FBPropertyString	BatchAddSubjects;	//!< Write only, registers every subject of a batch spec, see AddStreamObjectsFromSpec
+	FBPropertyString	BatchReport;		//!< Result and timing of the last batch
 
 private:
 	typedef TSharedPtr<IStreamObject> StreamObjectPtr;
 
-	void FbxRetrieveV4(FBFbxObject* FbxObject, kFbxObjectStore StoreWhat); //!< Retrieve from FBX file stored with the previous version.
+	void FbxRetrieveV4(FBFbxObject* FbxObject, kFbxObjectStore StoreWhat, TArray<StreamObjectPtr>* OutRecordObjects = nullptr); //!< Retrieve from FBX file stored with the previous version. Objects not found in the scene are recorded as null.
+	void FbxRetrieveV5(FBFbxObject* FbxObject, kFbxObjectStore StoreWhat, TArray<StreamObjectPtr>* OutRecordObjects = nullptr); //!< Retrieve what V5 stored, V6 only appends to it.
 
 public:
 	void AddStreamObject(int32 NewUID, StreamObjectPtr NewObject);
+	void AddStreamObjects(const TArray<TPair<int32, StreamObjectPtr>>& NewObjects); //!< Publishes all objects as a single registry version
 	void RemoveStreamObject(int32 DeletionKey, StreamObjectPtr RemoveObject);
+	void RemoveStreamObjects(const TArray<TPair<int32, StreamObjectPtr>>& RemoveObjects);
 	void ChangeSubjectName(StreamObjectPtr ObjectPtr, const char* NewSubjectNameStr);
-	void UpdateStreamObjects();
+
+	// One subject per line: ModelLongName|SubjectName|StreamingMode|Active|SendAnimatable, published at once. Returns the number added
+	int32 AddStreamObjectsFromSpec(const FString& Spec, FString& OutReport);
+
+	//--- Index lookups, nullptr if not streamed (the editor camera is streamed as UID -1)
+	const int32* FindUIDByModel(const FBModel* Model) const;
+	const int32* FindUIDByRootName(const FString& RootName) const;
+	const int32* FindUIDBySubjectName(FName SubjectName) const;
+	void UpdateStreamObjects(); //!< UI idle maintenance: prune invalid objects, refresh dirty ones while the device is offline
+
+	const TMap<int32, TSharedPtr<IStreamObject>>& GetStreamObjects() const { return StreamObjectRegistry.GetWriterView(); } //!< Latest stream objects, UI thread only
+	TSharedPtr<IStreamObject> FindStreamObject(int32 UID) const;
 
 	void SetDirty(bool bNewDirty) { bIsDirty = bNewDirty; };
 	bool IsDirty() const { return bIsDirty; };
 
+	void MarkStreamObjectDirty(const TSharedPtr<IStreamObject>& StreamObject); //!< Only this object's static data gets rebuilt
+	void MarkAllStreamObjectsDirty();
+
+	int32 GetRefreshCoalesceWindowMs() const { return RefreshCoalesceWindowMs; }
+	void SetRefreshCoalesceWindowMs(int32 InWindowMs);
+
+	int32 GetIdleKeepAliveMs() const { return IdleKeepAliveMs; }
+	void SetIdleKeepAliveMs(int32 InKeepAliveMs); //!< 0 sends every frame, otherwise frames that did not change are only resent at this interval
+
+	int32 GetMaxRenderSendRate() const { return MaxRenderSendRate; }
+	void SetMaxRenderSendRate(int32 InRate); //!< Frames per second sent at most in Before Render mode, 0 sends on every redraw
+
+	int32 GetIdleSendRate() const { return IdleSendRate; }
+	void SetIdleSendRate(int32 InRate); //!< Frames per second sent from the render callbacks while the transport is stopped and nothing is edited, 0 never throttles
+
+	bool IsTransactionAwareRefreshEnabled() const { return bTransactionAwareRefresh; }
+	void SetTransactionAwareRefreshEnabled(bool bEnabled);
+
 	void SetRefreshUI(bool bNewRefreshUI) { bShouldRefreshUI = bNewRefreshUI; };
 	bool ShouldRefreshUI() const { return bShouldRefreshUI; };
 
@@ -78,11 +121,24 @@ public:
 		TPair<FString, FFrameRate>(FString("100hz"), FFrameRate(100, 1)),
 		TPair<FString, FFrameRate>(FString("120hz"), FFrameRate(120, 1)),
 		TPair<FString, FFrameRate>(FString("Before Render"), FFrameRate(-1, 1)),
+		// Appended after Before Render since scenes store the index of their option
+		TPair<FString, FFrameRate>(FString("23.976hz"), FFrameRate(24000, 1001)),
+		TPair<FString, FFrameRate>(FString("59.94hz"), FFrameRate(60000, 1001)),
+		TPair<FString, FFrameRate>(FString("119.88hz"), FFrameRate(120000, 1001)),
+		TPair<FString, FFrameRate>(FString("240hz"), FFrameRate(240, 1)),
+		TPair<FString, FFrameRate>(FString("Reference Time"), FFrameRate(-2, 1)),
+		TPair<FString, FFrameRate>(FString("After DAG"), FFrameRate(-3, 1)),
+		TPair<FString, FFrameRate>(FString("Custom"), FFrameRate(-4, 1)),
 	};
 
 	FFrameRate CurrentSampleRate;
 	void UpdateSampleRate();
 
+	int32 GetCurrentSampleRateIndex() const; //!< Rates that are not one of the presets are shown as Custom
+
+	FFrameRate GetCustomSampleRate() const { return CustomSampleRate; }
+	void SetCustomSampleRate(FFrameRate InRate); //!< Any positive rate, also made current while the Custom option is selected
+
 	int32 GetNextUID();
 
 	bool IsEditorCameraStreamed() const;
@@ -103,11 +159,34 @@ public:
 	FString GetUnicastEndpoint() const;
 	void SetUnicastEndpoint(const FString& InEndpoint);
 
+	bool IsSenderThreadEnabled() const { return bUseSenderThread; }
+	void SetSenderThreadEnabled(bool bEnabled);
+
+	bool IsPacedSendingEnabled() const { return bPacedSending; }
+	void SetPacedSendingEnabled(bool bEnabled); //!< Send at the sample rate from the sender thread's own clock, needs the sender thread and a fixed rate
+	FMobuPacingStats GetPacingStats() const;
+
+	bool IsParallelFrameBuildEnabled() const { return bParallelFrameBuild; }
+	void SetParallelFrameBuildEnabled(bool bEnabled);
+
+	const FSkeletalSamplingSettings& GetSkeletalSamplingSettings() const { return SkeletalSamplingSettings; }
+	void SetSkeletalSamplingSettings(const FSkeletalSamplingSettings& InSettings); //!< Applied to every stream object, current and future
+
 public:
-	TMap<int32, TSharedPtr<IStreamObject>> StreamObjects;
 	TSharedPtr<ILiveLinkProvider> LiveLinkProvider;
 
 private:
+	FMobuStreamObjectRegistry StreamObjectRegistry;
+
+	//--- Writer side lookups, kept in sync by every add, remove and rename path
+	TMap<const FBModel*, int32> ModelToUID;
+	TMap<FString, int32> RootNameToUID;
+	TMap<FName, int32> SubjectNameToUID;
+
+	void IndexStreamObject(int32 UID, const StreamObjectPtr& StreamObject);
+	void UnindexStreamObject(int32 UID, const StreamObjectPtr& StreamObject);
+	void ReindexRootName(int32 UID, const StreamObjectPtr& StreamObject);
+
 	TWeakPtr<IStreamObject> EditorCameraObject;
 
 	FString CurrentProviderName = "Mobu Live Link";
@@ -116,22 +195,117 @@ private:
 
 	int32 NextUID = 1;
 
-	void UpdateStream(); //!< Get latest data and send to unreal
+	void UpdateStream(FBEvaluateInfo* EvaluateInfo); //!< Get latest data and send to unreal
+	void RefreshStreamObjects(const TMap<int32, TSharedPtr<IStreamObject>>& InStreamObjects); //!< Rebuild and send static data, caller must hold StreamUpdateLock
+	void RemoveInvalidStreamObjects(); //!< Writer side, drops objects whose root left the scene
+	void MarkStreamObjectsDirtyForComponent(FBComponent* Component); //!< Dirty every object whose hierarchy contains the component
+	void NotifyHierarchyEdit(FBComponent* Component, bool bDestroyed); //!< Let every object patch its hierarchy around the component
+	void InvalidateStaticBones(FBComponent* Component); //!< Classify static bones again when a constraint or a character changed
+	void UpdateDrivenModels(); //!< Gather the driven models again, only subjects with newly driven models are dirtied
+	void UpdateRootInScene(FBComponent* Component, bool bInScene); //!< Validity of the objects rooted at the component
+	void RevalidateStreamObjects(); //!< Full validity check against the scene, only after loads and clears
+	void DeferRefresh(); //!< Push the next refresh back by the coalescing window, called for every scene invalidation
+	bool IsRefreshDue() const; //!< False while a scene change storm or transaction is still in progress
+	bool IsStreamUpdateDue(bool bRenderCallback); //!< Applies the render rate cap and the idle rate, true once per frame that should be streamed
+	bool IsSceneIdle(double CurrentTime);
+	bool IsReferenceFrameDue(); //!< Always true unless sampling on the reference time, then true once per reference frame
+	void FlushPendingSubjectRemovals(); //!< Forward removals queued by writers to the provider, caller must hold StreamUpdateLock
+
+	//--- All provider traffic goes through these so it can be moved to the sender thread
+	void SendSubjectStaticData(FName SubjectName, TSubclassOf<ULiveLinkRole> Role, FLiveLinkStaticDataStruct&& StaticData);
+	void SendSubjectFrameData(FName SubjectName, const FLiveLinkFrameDataStruct& FrameData); //!< The frame keeps its buffers, the provider is sent a copy
+	void SendRemoveSubject(FName SubjectName);
+	void UpdateSenderPacing();
+
+	FFrameRate CustomSampleRate = FFrameRate(24, 1);
+
+	std::atomic<bool> bIsDirty{ false }; //!< At least one stream object is marked dirty
+	std::atomic<bool> bShouldRefreshUI{ false };
+	std::atomic<bool> bHasInvalidStreamObjects{ false }; //!< Set by the evaluation when it skipped an invalid object
+
+	int32 RefreshCoalesceWindowMs = 0; //!< Quiet period after the last scene change before dirty objects are rebuilt
+	int32 IdleKeepAliveMs = 0; //!< Interval at which a subject that does not move is still sent, 0 disables change detection
+	int32 MaxRenderSendRate = 0;
+	int32 IdleSendRate = 0;
+	std::atomic<double> LastStreamUpdateTime{ 0.0 }; //!< The device evaluation and the render callback may both stream while the sample rate changes
+	std::atomic<kLongLong> LastIdleCheckLocalTime{ 0 };
+	FFrameNumber LastReferenceFrame;
+	bool bHasReferenceFrame = false; //!< Whether LastReferenceFrame was streamed since sampling switched to the reference time
+	std::atomic<double> LastSceneActivityTime{ 0.0 };
+	std::atomic<int32> OpenSceneTransactions{ 0 }; //!< Tracked whatever bTransactionAwareRefresh says, an open transaction is a manipulation in progress
+	uint64 StaticDataGeneration = 0; //!< Bumped with every static data sent and recorded for that subject only, see FSentStaticData
+	bool bTransactionAwareRefresh = false; //!< Hold refreshes until every open scene transaction has ended
+	std::atomic<double> RefreshNotBefore{ 0.0 };
+	std::atomic<int32> SceneTransactionDepth{ 0 };
+
+	//--- What the provider last got for each subject, only touched under StreamUpdateLock
+	struct FSentStaticData
+	{
+		uint32 Hash = 0;
+		uint64 Generation = 0; //!< StaticDataGeneration when it was sent, a frame sent before that was dropped by UE
+	};
+	TMap<FName, FSentStaticData> SentStaticData;
+	TQueue<FName, EQueueMode::Mpsc> PendingSubjectRemovals; //!< Removed subjects, sent from the evaluation so they never overtake a frame in flight
 
-	int32 GetCurrentSampleRateIndex();
+	bool bShouldUpdateInRenderCallback = false; //!< Whether to update after render or to update in device evaluation
+	bool bShouldUpdateAfterDAG = false; //!< Whether the evaluation pipeline marks frames ready, they are still streamed from the render callback
+
+	//--- How long after its DAG evaluation a frame is streamed at Before Render
+	std::atomic<double> LastAfterDAGEntryTime{ 0.0 }; //!< Taken on the evaluation thread, consumed by the render callback
+	std::atomic<kLongLong> LastAfterDAGLocalTime{ 0 }; //!< Local time evaluated by that callback, to pair it with the frame being rendered
+	double AfterDAGLeadSumMs = 0.0; //!< Render callback only, as are the two below
+	double AfterDAGLeadMaxMs = 0.0;
+	int64 AfterDAGLeadCount = 0;
+	void TraceAfterDAGLead() const;
+
+	bool bUseSenderThread = false; //!< Whether provider calls are made from a dedicated thread instead of the evaluation callback
+	TUniquePtr<FMobuLiveLinkSender> Sender;
+	bool bPacedSending = false;
+
+	//--- Frame built for one stream object during UpdateStream, jobs and their frames are reused from one evaluation to the next
+	struct FFrameBuildJob
+	{
+		TSharedPtr<IStreamObject> StreamObject;
+		FLiveLinkFrameDataStruct FrameData;
+		bool bHasFrame = false;
+		bool bIsDue = true; //!< Whether the subject's rate class samples it on this update
+
+		double NextSampleTime = -1.0; //!< Deadline of a subject with an absolute rate, negative until first scheduled
+
+		// Change detection, only valid while the job keeps the same stream object
+		uint32 FrameHash = 0;
+		uint32 SentFrameHash = 0;
+		double SentFrameTime = 0.0;
+		uint64 SentStaticDataGeneration = 0;
+		bool bHasSentFrame = false;
+	};
 
-	bool bIsDirty = false;
-	bool bShouldRefreshUI = false;
+	std::atomic<bool> bParallelFrameBuild{ false }; //!< Whether stream objects build their frames concurrently before sending
+	TMap<int32, FFrameBuildJob> FrameBuildJobs; //!< Keyed by stream object UID, a skipped subject keeps its job
+	TArray<FFrameBuildJob*> DueFrameBuildJobs; //!< Scratch of UpdateStream, in the order the jobs are sent
+	uint64 FrameBuildJobsVersion = 0; //!< Registry version the jobs of removed stream objects were last dropped at
 
-	bool bShouldUpdateInRenderCallback = false; //!< Whether to update after render or to update in device evaluation
+	//--- Rate class scheduling, only touched by UpdateStream
+	uint64 StreamUpdateCount = 0;
+
+#if !UE_BUILD_SHIPPING
+	//--- Allocation check of the frame path, one update is counted once the subjects have settled
+	uint64 AllocationCheckVersion = 0;
+	int32 SettledStreamUpdateCount = 0;
+#endif
+
+	FSkeletalSamplingSettings SkeletalSamplingSettings;
+	FMobuDrivenModels DrivenModels;
+	bool bDrivenModelsStale = false; //!< UI thread only, a burst of constraint edits is gathered once at the next idle
 
 	FBDeviceSamplingMode SamplingType;
-	FBFastLock mCleanUpLock;
+	FCriticalSection StreamUpdateLock; //!< Serializes streaming with provider and sender swaps, UpdateStream only ever tries it
 
 	TMap<FBSceneChangeType, const char *> SceneChangeNameMap;
 
 	double LastEvaluationTime;
 	ETimecodeMode TimecodeMode;
+	FMobuTimecodeService TimecodeService;
 
 	void SetDeviceInformation(const char* NewDeviceInformation);
 	void TickCoreTicker();
@@ -0,0 +1,23 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "MobuLiveLinkCommon.h"
+#include "HAL/CriticalSection.h"
+
+// Models a constraint, character or device may move, gathered on the UI thread once for every subject
+class FMobuDrivenModels
+{
+public:
+	typedef TSet<const FBModel*> FModelSet;
+
+	// UI thread. Walks the scene and publishes the result, models that were not driven before are added to OutNewlyDrivenModels
+	void Gather(TArray<const FBModel*>* OutNewlyDrivenModels = nullptr);
+
+	// The last gathered set, empty until the first Gather()
+	TSharedRef<const FModelSet, ESPMode::ThreadSafe> Get() const;
+
+private:
+	TSharedRef<const FModelSet, ESPMode::ThreadSafe> Models = MakeShared<FModelSet, ESPMode::ThreadSafe>();
+	mutable FCriticalSection ModelsLock;
+};
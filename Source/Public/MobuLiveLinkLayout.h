@@ -32,10 +32,22 @@ public:
 	void EventTabPanelChange(HISender pSender, HKEvent pEvent);
 	void EventTimecodeModeChanged(HISender Sender, HKEvent Event);
 	void EventSampleRateChange(HISender Sender, HKEvent Event);
+	void EventCustomSampleRateChange(HISender Sender, HKEvent Event);
 	void EventEditProviderNamePopup(HISender Sender, HKEvent Event);
 	void EventChangeUnicastEndpoint(HISender Sender, HKEvent Event);
 	void EventAddStaticEndpoint(HISender Sender, HKEvent Event);
 	void EventRemoveStaticEndpoint(HISender Sender, HKEvent Event);
+	void EventSenderThreadChange(HISender Sender, HKEvent Event);
+	void EventParallelFrameBuildChange(HISender Sender, HKEvent Event);
+	void EventRefreshCoalesceWindowChange(HISender Sender, HKEvent Event);
+	void EventTransactionAwareChange(HISender Sender, HKEvent Event);
+	void EventSkeletalSamplingModeChange(HISender Sender, HKEvent Event);
+	void EventParallelBoneThresholdChange(HISender Sender, HKEvent Event);
+	void EventCacheStaticBonesChange(HISender Sender, HKEvent Event);
+	void EventIdleKeepAliveChange(HISender Sender, HKEvent Event);
+	void EventMaxRenderSendRateChange(HISender Sender, HKEvent Event);
+	void EventIdleSendRateChange(HISender Sender, HKEvent Event);
+	void EventPacedSendingChange(HISender Sender, HKEvent Event);
 
 public:
 
@@ -51,6 +63,9 @@ public:
 	FBLabel						TimecodeModeListLabel;
 	FBLabel						SampleRateListLabel;
 	FBList						SampleRateList;
+	FBEditNumber				CustomSampleRateNumerator;
+	FBLabel						CustomSampleRateSeparator;
+	FBEditNumber				CustomSampleRateDenominator;
 	FBLabel						ProviderNameLabel;
 	FBEdit						ProviderNameText;
 	FBButton					ProviderNameEditButton;
@@ -62,6 +77,23 @@ public:
 	FBList						StaticEndpoints;
 	FBButton					StaticEndpointAddButton;
 	FBButton					StaticEndpointRemoveButton;
+	FBButton					SenderThreadButton;
+	FBButton					ParallelFrameBuildButton;
+	FBLabel						RefreshCoalesceLabel;
+	FBEditNumber				RefreshCoalesceWindow;
+	FBButton					TransactionAwareButton;
+	FBLabel						SkeletalSamplingModeLabel;
+	FBList						SkeletalSamplingModeList;
+	FBLabel						ParallelBoneThresholdLabel;
+	FBEditNumber				ParallelBoneThreshold;
+	FBButton					CacheStaticBonesButton;
+	FBLabel						IdleKeepAliveLabel;
+	FBEditNumber				IdleKeepAlive;
+	FBLabel						MaxRenderSendRateLabel;
+	FBEditNumber				MaxRenderSendRate;
+	FBLabel						IdleSendRateLabel;
+	FBEditNumber				IdleSendRate;
+	FBButton					PacedSendingButton;
 
 private:
 	typedef TSharedPtr<IStreamObject> StreamObjectPtr;
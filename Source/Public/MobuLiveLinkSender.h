@@ -0,0 +1,187 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "MobuLiveLinkCommon.h"
+#include "Containers/Queue.h"
+#include "HAL/Runnable.h"
+#include "Templates/SubclassOf.h"
+
+#include <atomic>
+
+class FEvent;
+class FRunnableThread;
+class ULiveLinkRole;
+
+// Bounded lock-free ring for one producer and one consumer thread, slots are filled in place and reused
+template<typename ElementType>
+class TMobuSpscRing
+{
+public:
+	explicit TMobuSpscRing(uint32 InCapacity)
+		: Mask(FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(InCapacity, 2)) - 1)
+	{
+		Slots.SetNum(Mask + 1);
+	}
+
+	// Producer: returns the next free slot, or nullptr if the consumer has fallen a full ring behind
+	ElementType* BeginWrite()
+	{
+		const uint32 CurrentTail = Tail.load(std::memory_order_relaxed);
+		if (CurrentTail - Head.load(std::memory_order_acquire) > Mask)
+		{
+			return nullptr;
+		}
+		return &Slots[CurrentTail & Mask];
+	}
+
+	// Producer: publishes the slot returned by the last BeginWrite()
+	void EndWrite()
+	{
+		Tail.store(Tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Consumer: returns the oldest published slot, or nullptr if the ring is empty
+	ElementType* BeginRead()
+	{
+		const uint32 CurrentHead = Head.load(std::memory_order_relaxed);
+		if (CurrentHead == Tail.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		return &Slots[CurrentHead & Mask];
+	}
+
+	// Consumer: hands the slot returned by the last BeginRead() back to the producer
+	void EndRead()
+	{
+		Head.store(Head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	bool IsEmpty() const
+	{
+		return Head.load(std::memory_order_acquire) == Tail.load(std::memory_order_acquire);
+	}
+
+	// Sequence number of the next slot the consumer will read
+	uint32 GetReadSequence() const
+	{
+		return Head.load(std::memory_order_acquire);
+	}
+
+	// Sequence number of the next slot the producer will publish, safe to sample from any thread
+	uint32 GetWriteSequence() const
+	{
+		return Tail.load(std::memory_order_acquire);
+	}
+
+private:
+	TArray<ElementType> Slots;
+	const uint32 Mask;
+
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Head{ 0 };
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Tail{ 0 };
+};
+
+// One provider call recorded on the evaluation side and replayed on the sender thread
+struct FMobuLiveLinkSenderCommand
+{
+	enum class EType : uint8
+	{
+		StaticData,
+		FrameData,
+	};
+
+	EType Type = EType::FrameData;
+	FName SubjectName;
+	TSubclassOf<ULiveLinkRole> Role;
+	FLiveLinkStaticDataStruct StaticData;
+	FLiveLinkFrameDataStruct FrameData;
+};
+
+// How far the paced sends landed from their deadlines since pacing last started
+struct FMobuPacingStats
+{
+	uint64 TickCount = 0;
+	uint64 MissedTickCount = 0; //!< Deadlines skipped because the thread woke up more than a period late
+	double MeanLatenessMs = 0.0;
+	double MaxLatenessMs = 0.0;
+};
+
+// Thread owning all provider traffic while threaded sending is on, paced frames go out on its own clock
+class FMobuLiveLinkSender : public FRunnable
+{
+public:
+	FMobuLiveLinkSender(const TSharedPtr<ILiveLinkProvider>& InProvider, uint32 InCapacity = 1024);
+	virtual ~FMobuLiveLinkSender();
+
+	// Producer side. Only one thread may produce at a time (the device holds its stream update lock while producing)
+
+	// Static data is never dropped, the producer yields until the ring has room
+	void EnqueueStaticData(FName SubjectName, TSubclassOf<ULiveLinkRole> Role, FLiveLinkStaticDataStruct&& StaticData);
+
+	// Copied into the slot's own buffers. Returns false if dropped because the sender thread is a full ring behind
+	bool EnqueueFrameData(FName SubjectName, const FLiveLinkFrameDataStruct& FrameData);
+
+	// Removal can come from any thread (UI edits). It is replayed after every command published before the call
+	void EnqueueRemoveSubject(FName SubjectName);
+
+	// Wake the sender thread once the producer finished a batch
+	void Wake();
+
+	// Any thread. A rate without a positive numerator stops pacing, frames are then sent as soon as they are enqueued
+	void SetPacingRate(FFrameRate InRate);
+	bool IsPacing() const { return PacingPeriod.load(std::memory_order_relaxed) > 0.0; }
+	FMobuPacingStats GetPacingStats() const;
+
+	uint64 GetDroppedFrameCount() const { return DroppedFrameCount.load(std::memory_order_relaxed); }
+
+	// FRunnable Interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	void DrainCommands();
+	void ProcessRemovals(uint32 ReadSequence);
+
+	//--- Pacing, sender thread only
+	void StartPacing(double Period);
+	void StopPacing();
+	bool WaitForDeadline(); //!< False if pacing changed or a stop was requested before the deadline
+	void SendPacedFrames();
+
+	TSharedPtr<ILiveLinkProvider> Provider;
+
+	TMobuSpscRing<FMobuLiveLinkSenderCommand> Commands;
+	TQueue<TPair<uint32, FName>, EQueueMode::Mpsc> PendingRemovals;
+
+	FEvent* WakeEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+
+	std::atomic<bool> bStopRequested{ false };
+	std::atomic<uint64> DroppedFrameCount{ 0 };
+
+	// Latest frame of each subject while pacing, overwritten by the producer and taken by the sender thread
+	struct FPacedFrame
+	{
+		FLiveLinkFrameDataStruct FrameData;
+		bool bIsNew = false;
+	};
+	FCriticalSection PacedFramesLock;
+	TMap<FName, FPacedFrame> PacedFrames;
+
+	// Frames swapped out of PacedFrames for the current deadline, buffers go back and forth between the two
+	TArray<FName> PacedSubjectNames;
+	TArray<FLiveLinkFrameDataStruct> PacedFrameData;
+	int32 PacedFrameCount = 0;
+
+	std::atomic<double> PacingPeriod{ 0.0 }; //!< Seconds, 0 while not pacing
+	double ActivePeriod = 0.0; //!< Period the sender thread is pacing at
+	double PacingOrigin = 0.0;
+	double NextDeadline = 0.0;
+	uint64 PacingTick = 0;
+
+	mutable FCriticalSection PacingStatsLock;
+	FMobuPacingStats PacingStats;
+	double PacingLatenessSum = 0.0;
+};
@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "MobuLiveLinkCommon.h"
+#include "IStreamObject.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+// Copy-on-write set of stream objects, writers publish new versions and the evaluation reads wait-free
+class FMobuStreamObjectRegistry
+{
+public:
+	typedef TMap<int32, TSharedPtr<IStreamObject>> FStreamObjectMap;
+
+	struct FSnapshot
+	{
+		FStreamObjectMap StreamObjects;
+		uint64 Version = 0;
+	};
+
+	FMobuStreamObjectRegistry();
+	~FMobuStreamObjectRegistry();
+
+	// Reader side. Only one reader may hold a snapshot at a time (the device evaluates under its stream update lock)
+
+	// Protect and return the current version, it stays alive until ReleaseRead() even if writers publish
+	const FSnapshot& AcquireRead();
+	void ReleaseRead();
+
+	// Writer side. The returned map is the latest version, only valid until the calling thread publishes again
+	const FStreamObjectMap& GetWriterView() const;
+
+	uint64 GetVersion() const;
+
+	void Add(int32 UID, const TSharedPtr<IStreamObject>& StreamObject);
+	bool Remove(int32 UID);
+	void Empty();
+
+	// Apply several edits to a private copy and publish them as a single version
+	void Modify(TFunctionRef<void(FStreamObjectMap&)> Edit);
+
+private:
+	void Publish(FSnapshot* NewSnapshot);
+	void ReclaimRetired();
+
+	std::atomic<FSnapshot*> Current;
+	std::atomic<FSnapshot*> Hazard{ nullptr };
+
+	// Versions replaced by a writer that may still be protected by the reader
+	TArray<FSnapshot*> Retired;
+	FCriticalSection WriteLock;
+};
@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "MobuLiveLinkCommon.h"
+#include "MobuLiveLinkUtilities.h"
+
+#include <atomic>
+
+// Timecode of streamed frames, the transport rate and reference source are cached until the UI thread sees them change
+class FMobuTimecodeService
+{
+public:
+	FMobuTimecodeService();
+
+	// Only called from the thread that streams frames
+	FQualifiedFrameTime GetTimecode(ETimecodeMode TimecodeMode);
+
+	// Streaming thread only. False, with a frame of the monotonic clock, while no reference time source exists
+	bool GetReferenceFrame(FFrameNumber& OutFrame);
+
+	// Transport settings or reference time sources may have changed, from any thread
+	void Invalidate() { bIsCacheValid = false; }
+
+	// UI thread only. Invalidates the cache if the transport rate or the reference time sources changed since the last call
+	void CheckTransportSettings();
+
+	// Align the system timecode on the wall clock again at the next frame, from any thread
+	void Resync() { bIsTimeOfDayAligned = false; }
+
+private:
+	void UpdateCache(ETimecodeMode TimecodeMode);
+
+	std::atomic<bool> bIsCacheValid{ false };
+	ETimecodeMode CachedTimecodeMode = ETimecodeMode::TimecodeMode_Local;
+	FFrameRate FrameRate;
+	bool bReferenceFrameRequested = false; //!< The reference time source is looked up whatever the timecode mode once frames are sampled on it
+
+	// Time of day at the origin of FPlatformTime::Seconds(), taken from the wall clock once so the timecode never steps
+	double TimeOfDayOffset = 0.0;
+	std::atomic<bool> bIsTimeOfDayAligned{ false };
+
+	TUniquePtr<FBReferenceTime> ReferenceTime;
+	int ReferenceTimeID = -1; //!< -1 while no reference time source exists
+	bool bReportedMissingReference = false; //!< Missing sources are reported once until one shows up
+
+	// Last seen by CheckTransportSettings, UI thread only
+	TUniquePtr<FBReferenceTime> ObservedReferenceTime;
+	FBTimeMode ObservedTransportFps = FBTimeMode::kFBTimeModeDefault;
+	double ObservedTransportFpsValue = 0.0;
+	int ObservedReferenceTimeID = -1;
+	int ObservedReferenceTimeCount = 0;
+};
@@ -11,17 +11,219 @@ enum class ETimecodeMode : int32
 	TimecodeMode_Reference	= 2
 };
 
+enum class ESkeletalSamplingMode : int32
+{
+	SkeletalSampling_Global	= 0,	// Sample global matrices and make them relative to their parent
+	SkeletalSampling_Local	= 1		// Sample matrices relative to their parent, only the root is read in global space
+};
+
+// Device wide options of the skeletal frame path
+struct FSkeletalSamplingSettings
+{
+	ESkeletalSamplingMode Mode = ESkeletalSamplingMode::SkeletalSampling_Global;
+	int32 ParallelBoneThreshold = 512; // Hierarchies with at least this many bones are sampled on several threads, 0 never does
+	bool bCacheStaticBones = false; // Opt in, undriven bones are reused and only resampled every 30 frames, stale until then if moved without a scene event
+};
+
+// How often one subject is sampled and sent, both limits apply when both are set
+struct FStreamRateClass
+{
+	int32 Divisor = 1; // Sampled on every Nth device update, subjects sharing a divisor take turns on different updates
+	int32 MaxRate = 0; // Sampled at most this many times per second, 0 leaves only the divisor
+};
+
+// Compile time signed permutations: Out(Row, Column) = RowSign[Row] * ColumnSign[Column] * In(RowSource[Row], ColumnSource[Column])
+namespace MobuCoordinateSystem
+{
+	// Y-Up right handed MotionBuilder to Z-Up left handed Unreal, both in centimeters
+	struct FUnrealSpace
+	{
+		static constexpr int32 RowSource[4] = { 0, 1, 2, 3 };
+		static constexpr double RowSign[4] = { 1.0, -1.0, 1.0, 1.0 };
+		static constexpr int32 ColumnSource[3] = { 0, 2, 1 };
+		static constexpr double ColumnSign[3] = { 1.0, 1.0, 1.0 };
+		static constexpr double UnitScale = 1.0;
+	};
+
+	// Cameras of a space: MotionBuilder cameras look down X with Y up, Unreal cameras look down X with Z up
+	template<typename SpacePolicy>
+	struct TCameraSpace
+	{
+		static constexpr int32 CameraRowSource[3] = { 0, 2, 1 };
+		static constexpr double CameraRowSign[3] = { 1.0, 1.0, -1.0 };
+
+		static constexpr int32 RowSource[4] =
+		{
+			SpacePolicy::RowSource[CameraRowSource[0]],
+			SpacePolicy::RowSource[CameraRowSource[1]],
+			SpacePolicy::RowSource[CameraRowSource[2]],
+			SpacePolicy::RowSource[3],
+		};
+		static constexpr double RowSign[4] =
+		{
+			CameraRowSign[0] * SpacePolicy::RowSign[CameraRowSource[0]],
+			CameraRowSign[1] * SpacePolicy::RowSign[CameraRowSource[1]],
+			CameraRowSign[2] * SpacePolicy::RowSign[CameraRowSource[2]],
+			SpacePolicy::RowSign[3],
+		};
+		static constexpr int32 ColumnSource[3] = { SpacePolicy::ColumnSource[0], SpacePolicy::ColumnSource[1], SpacePolicy::ColumnSource[2] };
+		static constexpr double ColumnSign[3] = { SpacePolicy::ColumnSign[0], SpacePolicy::ColumnSign[1], SpacePolicy::ColumnSign[2] };
+		static constexpr double UnitScale = SpacePolicy::UnitScale;
+	};
+
+	// Relative to a parent, the axis change applies on both sides so only the root carries the Y-Up correction
+	template<typename SpacePolicy>
+	struct TLocalSpace
+	{
+		static constexpr int32 RowSource[4] = { SpacePolicy::RowSource[0], SpacePolicy::RowSource[1], SpacePolicy::RowSource[2], SpacePolicy::RowSource[3] };
+		static constexpr double RowSign[4] = { SpacePolicy::RowSign[0], SpacePolicy::RowSign[1], SpacePolicy::RowSign[2], SpacePolicy::RowSign[3] };
+		static constexpr int32 ColumnSource[3] = { SpacePolicy::RowSource[0], SpacePolicy::RowSource[1], SpacePolicy::RowSource[2] };
+		static constexpr double ColumnSign[3] = { SpacePolicy::RowSign[0], SpacePolicy::RowSign[1], SpacePolicy::RowSign[2] };
+		static constexpr double UnitScale = SpacePolicy::UnitScale;
+	};
+
+	typedef TCameraSpace<FUnrealSpace> FUnrealCameraSpace;
+	typedef TLocalSpace<FUnrealSpace> FUnrealLocalSpace;
+}
+
 class MobuUtilities
 {
 public:
 	static const float InchesToMillimeters;
 
-	static FTransform MobuTransformToUnreal(FBMatrix MobuTransfrom);
 	static FColor MobuColorToUnreal(FBColor Color);
-	static FTransform UnrealTransformFromModel(FBModel* MobuModel, bool bIsGlobal = true);
-	static TArray<FName> GetAllAnimatableCurveNames(FBModel* MobuModel, const FString& Prefix = FString());
-	static TArray<float> GetAllAnimatableCurveValues(FBModel* MobuModel);
+	static FTransform UnrealTransformFromModel(FBModel* MobuModel, bool bIsGlobal = true, FBEvaluateInfo* EvaluateInfo = nullptr);
+	static FTransform UnrealCameraTransformFromModel(FBModel* MobuModel, bool bIsGlobal = true, FBEvaluateInfo* EvaluateInfo = nullptr);
+
+	static void GetModelMatrix(FBModel* MobuModel, FBMatrix& OutTransform, bool bIsGlobal = true, FBEvaluateInfo* EvaluateInfo = nullptr);
+
+	// Scalar reference and vectorized batch, instantiated for the MobuCoordinateSystem policies
+	template<typename SpacePolicy>
+	static FTransform ConvertTransform(FBMatrix MobuTransform);
+	template<typename SpacePolicy>
+	static void ConvertTransforms(const FBMatrix* MobuTransforms, int32 Count, FTransform* OutTransforms);
+
+#if !UE_BUILD_SHIPPING
+	// Checks every policy against the scalar and baseline conversions, false on any disagreement
+	static bool CheckTransformConversions();
+
+	// Counts the heap allocations the calling thread makes while in scope, only one counter may be live at a time
+	class FScopedAllocationCounter
+	{
+	public:
+		FScopedAllocationCounter();
+		~FScopedAllocationCounter();
+
+		int32 GetCount() const;
+	};
+
+	// Allocations the calling thread makes in this scope are left out of the live counter
+	class FScopedAllocationCounterExclusion
+	{
+	public:
+		FScopedAllocationCounterExclusion();
+		~FScopedAllocationCounterExclusion();
+	};
+#endif
+
+	// Keeps the frame's allocation when it already holds the given struct, every field is then overwritten in place
+	static void InitializeFrameData(FLiveLinkFrameDataStruct& FrameData, const UScriptStruct* Struct);
+	// Copy into the destination's existing allocation, arrays only grow when the topology did
+	static void CopyFrameData(const FLiveLinkFrameDataStruct& Source, FLiveLinkFrameDataStruct& Dest);
+
+	// Role, struct and every field, equal when UE would build the same subject
+	static uint32 HashStaticData(const UClass* Role, const FLiveLinkStaticDataStruct& StaticData);
+
+	// Sampled values only, a scene that does not move hashes the same every frame
+	static uint32 HashFrameData(const FLiveLinkFrameDataStruct& FrameData);
 
 	static FFrameRate TimeModeToFrameRate(FBTimeMode TimeMode);
-	static FQualifiedFrameTime GetSceneTimecode(ETimecodeMode TimecodeMode);
+};
+
+// Animatable properties of a subject, resolved with its static data and sampled without walking PropertyLists
+class FMobuAnimatableCurveTable
+{
+public:
+	void Reset();
+
+	// Append the streamable animatable properties as "<Prefix>:<PropertyName>", in sampling order
+	void AddModel(FBModel* MobuModel, const FString& Prefix, TArray<FName>& OutNames);
+
+	int32 Num() const { return Accessors.Num(); }
+
+	// OutValues is resized to Num(), its allocation is kept from one frame to the next
+	void Sample(FBEvaluateInfo* EvaluateInfo, TArray<float>& OutValues) const;
+
+private:
+	struct FAccessor
+	{
+		FBProperty* Property;
+		FBPropertyType Type;
+		int32 Offset; //!< Index of the value in the frame's PropertyValues
+	};
+
+	TArray<FAccessor> Accessors;
+};
+
+// Hierarchy under a root flattened parents first, rebuilt when its signature changes and patched in place on edits
+class FMobuFlatHierarchy
+{
+public:
+	enum class EFilter : uint8
+	{
+		AllModels,
+		JointsOnly,	// Skeleton and root models, the walk does not go below any other model
+	};
+
+	// Scene change around a model: its parent may have changed, or it is about to be destroyed
+	struct FEdit
+	{
+		const FBModel* Model;
+		bool bDestroyed;
+	};
+
+	// Returns true if the hierarchy was rebuilt
+	bool Update(const FBModel* RootModel, EFilter Filter);
+
+	// Patch the edited subtrees, rebuilds if the result does not match the scene. Returns true if the hierarchy changed
+	bool ApplyEdits(const TArray<FEdit>& Edits);
+
+	void Reset();
+
+	int32 Num() const { return Models.Num(); }
+
+	const TArray<const FBModel*>& GetModels() const { return Models; }
+	const TArray<int32>& GetParents() const { return Parents; } //!< -1 for the root
+	const TArray<FName>& GetNames() const { return Names; }
+	const TArray<bool>& GetHasChildren() const { return HasChildren; }
+
+private:
+	static bool IsIncluded(FBModel* Model, EFilter Filter);
+	static uint32 HashNode(const FBModel* Model); //!< Model and name, where it hangs is mixed in by the signature
+
+	// Walks the scene in build order, every node is mixed in after the walk index of its parent
+	uint32 ComputeSignature(const FBModel* RootModel, EFilter Filter, int32& OutCount);
+	// Whether every model of the scene is in the arrays under the same parent and name, whatever order patches left them in
+	bool MatchesScene(const FBModel* RootModel, EFilter Filter);
+
+	void Build(const FBModel* RootModel, EFilter Filter);
+	void AddNode(const FBModel* Model, int32 ParentIndex);
+	void UpdateHasChildren();
+
+	bool DetachModel(const FBModel* Model);
+	bool ReparentModel(const FBModel* Model, EFilter Filter);
+
+	TArray<const FBModel*> Models;
+	TArray<int32> Parents;
+	TArray<FName> Names;
+	TArray<bool> HasChildren;
+	TArray<uint32> NodeHashes;
+	TMap<const FBModel*, int32> ModelToIndex;
+
+	const FBModel* BuiltRoot = nullptr;
+	EFilter BuiltFilter = EFilter::AllModels;
+	uint32 BuiltSignature = 0;
+
+	TArray<TPair<FBModel*, int32>> WalkQueue; //!< Scratch of the scene walks, model and the walk index of its parent
+	TArray<int32> Remap; //!< Scratch of DetachModel
 };
\ No newline at end of file
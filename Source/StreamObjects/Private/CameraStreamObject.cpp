@@ -10,23 +10,6 @@
 #include "Roles/LiveLinkTransformRole.h"
 #include "Roles/LiveLinkTransformTypes.h"
 
-namespace
-{
-	void FixCameraRotation(FTransform& CameraTransform)
-	{
-		FMatrix InMatrix = CameraTransform.ToMatrixWithScale();
-
-		FVector DestAxisX = InMatrix.GetScaledAxis(EAxis::X);
-		FVector DestAxisY = InMatrix.GetScaledAxis(EAxis::Z);
-		FVector DestAxisZ = InMatrix.GetScaledAxis(EAxis::Y) * -1.0f;
-
-		FMatrix Result(InMatrix);
-		Result.SetAxes(&DestAxisX, &DestAxisY, &DestAxisZ);
-
-		CameraTransform.SetFromMatrix(Result);
-	}
-}
-
 FCameraStreamObject::FCameraStreamObject(const FBModel* ModelPointer) :
 	FModelStreamObject(ModelPointer)
 {
@@ -38,57 +21,56 @@ const FString FCameraStreamObject::GetStreamOptions() const
 	return FString::Join(CameraStreamOptions, _T("~"));
 };
 
-void FCameraStreamObject::Refresh(const TSharedPtr<ILiveLinkProvider> Provider)
+bool FCameraStreamObject::Refresh(TSubclassOf<ULiveLinkRole>& OutRole, FLiveLinkStaticDataStruct& OutStaticData)
 {
 	if (GetStreamingMode() == FCameraStreamMode::RootOnly)
 	{
-		FLiveLinkStaticDataStruct TransformData(FLiveLinkTransformStaticData::StaticStruct());
-		UpdateSubjectTransformStaticData(RootModel, bSendAnimatable, *TransformData.Cast<FLiveLinkTransformStaticData>());
-		Provider->UpdateSubjectStaticData(SubjectName, ULiveLinkTransformRole::StaticClass(), MoveTemp(TransformData));
+		OutStaticData.InitializeWith(FLiveLinkTransformStaticData::StaticStruct(), nullptr);
+		UpdateSubjectTransformStaticData(RootModel, GetStreamedCurveTable(), *OutStaticData.Cast<FLiveLinkTransformStaticData>());
+		OutRole = ULiveLinkTransformRole::StaticClass();
 	}
 	else if (GetStreamingMode() == FCameraStreamMode::FullHierarchy)
 	{
-		FLiveLinkStaticDataStruct SkeletonData(FLiveLinkSkeletonStaticData::StaticStruct());
-		UpdateSubjectSkeletalStaticData(*SkeletonData.Cast<FLiveLinkSkeletonStaticData>());
-		Provider->UpdateSubjectStaticData(SubjectName, ULiveLinkAnimationRole::StaticClass(), MoveTemp(SkeletonData));
+		OutStaticData.InitializeWith(FLiveLinkSkeletonStaticData::StaticStruct(), nullptr);
+		UpdateSubjectSkeletalStaticData(*OutStaticData.Cast<FLiveLinkSkeletonStaticData>());
+		OutRole = ULiveLinkAnimationRole::StaticClass();
 	}
 	else
 	{
-		FLiveLinkStaticDataStruct CameraData(FLiveLinkCameraStaticData::StaticStruct());
-		FModelStreamObject::UpdateSubjectTransformStaticData(RootModel, bSendAnimatable, *CameraData.Cast<FLiveLinkCameraStaticData>());
-		UpdateSubjectCameraStaticData(static_cast<const FBCamera*>(RootModel), *CameraData.Cast<FLiveLinkCameraStaticData>());
-		Provider->UpdateSubjectStaticData(SubjectName, ULiveLinkCameraRole::StaticClass(), MoveTemp(CameraData));
+		OutStaticData.InitializeWith(FLiveLinkCameraStaticData::StaticStruct(), nullptr);
+		FModelStreamObject::UpdateSubjectTransformStaticData(RootModel, GetStreamedCurveTable(), *OutStaticData.Cast<FLiveLinkCameraStaticData>());
+		UpdateSubjectCameraStaticData(static_cast<const FBCamera*>(RootModel), *OutStaticData.Cast<FLiveLinkCameraStaticData>());
+		OutRole = ULiveLinkCameraRole::StaticClass();
 	}
+	return true;
 }
 
-void FCameraStreamObject::UpdateSubjectFrame(const TSharedPtr<ILiveLinkProvider> Provider, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime)
+bool FCameraStreamObject::UpdateSubjectFrame(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkFrameDataStruct& OutFrameData)
 {
 	if (!bIsActive)
 	{
-		return;
+		return false;
 	}
 
 	if (GetStreamingMode() == FCameraStreamMode::RootOnly)
 	{
-		FLiveLinkFrameDataStruct TransformData = (FLiveLinkTransformFrameData::StaticStruct());
-		FLiveLinkTransformFrameData& CameraTransformData = *TransformData.Cast<FLiveLinkTransformFrameData>();
-		UpdateSubjectTransformFrameData(RootModel, bSendAnimatable, WorldTime, QualifiedFrameTime, CameraTransformData);
-		FixCameraRotation(CameraTransformData.Transform);
-		Provider->UpdateSubjectFrameData(SubjectName, MoveTemp(TransformData));
+		MobuUtilities::InitializeFrameData(OutFrameData, FLiveLinkTransformFrameData::StaticStruct());
+		FLiveLinkTransformFrameData& CameraTransformData = *OutFrameData.Cast<FLiveLinkTransformFrameData>();
+		UpdateBaseFrameData(GetStreamedCurveTable(), WorldTime, QualifiedFrameTime, EvaluateInfo, CameraTransformData);
+		CameraTransformData.Transform = MobuUtilities::UnrealCameraTransformFromModel(const_cast<FBModel*>(RootModel), true, EvaluateInfo);
 	}
 	else if (GetStreamingMode() == FCameraStreamMode::FullHierarchy)
 	{
-		FLiveLinkFrameDataStruct TransformData = (FLiveLinkAnimationFrameData::StaticStruct());
-		UpdateSubjectSkeletalFrameData(WorldTime, QualifiedFrameTime, *TransformData.Cast<FLiveLinkAnimationFrameData>());
-		Provider->UpdateSubjectFrameData(SubjectName, MoveTemp(TransformData));
+		MobuUtilities::InitializeFrameData(OutFrameData, FLiveLinkAnimationFrameData::StaticStruct());
+		UpdateSubjectSkeletalFrameData(WorldTime, QualifiedFrameTime, EvaluateInfo, *OutFrameData.Cast<FLiveLinkAnimationFrameData>());
 	}
 	else
 	{
-		FLiveLinkFrameDataStruct CameraData(FLiveLinkCameraFrameData::StaticStruct());
-		FModelStreamObject::UpdateSubjectTransformFrameData(RootModel, bSendAnimatable, WorldTime, QualifiedFrameTime, *CameraData.Cast<FLiveLinkTransformFrameData>());
-		UpdateSubjectCameraFrameData(static_cast<const FBCamera*>(RootModel), *CameraData.Cast<FLiveLinkCameraFrameData>());
-		Provider->UpdateSubjectFrameData(SubjectName, MoveTemp(CameraData));
+		MobuUtilities::InitializeFrameData(OutFrameData, FLiveLinkCameraFrameData::StaticStruct());
+		FModelStreamObject::UpdateBaseFrameData(GetStreamedCurveTable(), WorldTime, QualifiedFrameTime, EvaluateInfo, *OutFrameData.Cast<FLiveLinkCameraFrameData>());
+		UpdateSubjectCameraFrameData(static_cast<const FBCamera*>(RootModel), EvaluateInfo, *OutFrameData.Cast<FLiveLinkCameraFrameData>());
 	}
+	return true;
 }
 
 void FCameraStreamObject::UpdateSubjectCameraStaticData(const FBCamera* CameraModel, FLiveLinkCameraStaticData& InOutCameraStatic)
@@ -109,15 +91,15 @@ void FCameraStreamObject::UpdateSubjectCameraStaticData(const FBCamera* CameraMo
 	InOutCameraStatic.bIsFocusDistanceSupported = (FocusMethod == FBCameraFocusDistanceSource::kFBFocusDistanceSpecificDistance);
 }
 
-void FCameraStreamObject::UpdateSubjectCameraFrameData(const FBCamera* CameraModel, FLiveLinkCameraFrameData& InOutCameraFrame)
+void FCameraStreamObject::UpdateSubjectCameraFrameData(const FBCamera* CameraModel, FBEvaluateInfo* EvaluateInfo, FLiveLinkCameraFrameData& InOutCameraFrame)
 {
-	FixCameraRotation(InOutCameraFrame.Transform);
+	InOutCameraFrame.Transform = MobuUtilities::UnrealCameraTransformFromModel(const_cast<FBCamera*>(CameraModel), true, EvaluateInfo);
 
 	double FieldOfView, FilmAspectRatio, FocalLength, FocusSpecificDistance;
-	CameraModel->FieldOfView.GetData(&FieldOfView, sizeof(FieldOfView), nullptr);
-	CameraModel->FilmAspectRatio.GetData(&FilmAspectRatio, sizeof(FilmAspectRatio), nullptr);
-	CameraModel->FocalLength.GetData(&FocalLength, sizeof(FocalLength), nullptr);
-	CameraModel->FocusSpecificDistance.GetData(&FocusSpecificDistance, sizeof(FocusSpecificDistance), nullptr);
+	CameraModel->FieldOfView.GetData(&FieldOfView, sizeof(FieldOfView), EvaluateInfo);
+	CameraModel->FilmAspectRatio.GetData(&FilmAspectRatio, sizeof(FilmAspectRatio), EvaluateInfo);
+	CameraModel->FocalLength.GetData(&FocalLength, sizeof(FocalLength), EvaluateInfo);
+	CameraModel->FocusSpecificDistance.GetData(&FocusSpecificDistance, sizeof(FocusSpecificDistance), EvaluateInfo);
 
 	InOutCameraFrame.FieldOfView = FieldOfView;
 	InOutCameraFrame.AspectRatio = FilmAspectRatio;
@@ -125,6 +107,6 @@ void FCameraStreamObject::UpdateSubjectCameraFrameData(const FBCamera* CameraMod
 	InOutCameraFrame.FocusDistance = FocusSpecificDistance;
 
 	FBCameraType CameraType;
-	CameraModel->Type.GetData(&CameraType, sizeof(CameraType), nullptr);
+	CameraModel->Type.GetData(&CameraType, sizeof(CameraType), EvaluateInfo);
 	InOutCameraFrame.ProjectionMode = CameraType == FBCameraType::kFBCameraTypePerspective ? ELiveLinkCameraProjectionMode::Perspective : ELiveLinkCameraProjectionMode::Orthographic;
 }
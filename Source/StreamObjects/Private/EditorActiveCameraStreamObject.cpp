@@ -55,25 +55,45 @@ void FEditorActiveCameraStreamObject::UpdateStreamingMode(int NewStreamingMode)
 
 bool FEditorActiveCameraStreamObject::GetActiveStatus() const
 {
-	return bIsActive;
+	return bIsActive.load();
 };
 
 void FEditorActiveCameraStreamObject::UpdateActiveStatus(bool bIsNowActive)
 {
-	bIsActive = bIsNowActive;
+	bIsActive.store(bIsNowActive);
 };
 
 bool FEditorActiveCameraStreamObject::GetSendAnimatableStatus() const
 {
-	return bSendAnimatable;
+	return bSendAnimatable.load();
 };
 
 void FEditorActiveCameraStreamObject::UpdateSendAnimatableStatus(bool bNewSendAnimatable)
 {
-	if (bSendAnimatable != bNewSendAnimatable)
-	{
-		bSendAnimatable = bNewSendAnimatable;
-	}
+	bSendAnimatable.store(bNewSendAnimatable);
+};
+
+FStreamRateClass FEditorActiveCameraStreamObject::GetRateClass() const
+{
+	return RateClass.load();
+};
+
+void FEditorActiveCameraStreamObject::UpdateRateClass(const FStreamRateClass& NewRateClass)
+{
+	FStreamRateClass ClampedRateClass;
+	ClampedRateClass.Divisor = FMath::Max(NewRateClass.Divisor, 1);
+	ClampedRateClass.MaxRate = FMath::Max(NewRateClass.MaxRate, 0);
+	RateClass.store(ClampedRateClass);
+};
+
+void FEditorActiveCameraStreamObject::UpdateSkeletalSamplingSettings(const FSkeletalSamplingSettings& NewSettings)
+{
+	// The editor camera has no hierarchy
+};
+
+void FEditorActiveCameraStreamObject::UpdateDrivenModels(const FMobuDrivenModels* NewDrivenModels)
+{
+	// The editor camera has no hierarchy
 };
 
 const FBModel* FEditorActiveCameraStreamObject::GetModelPointer() const
@@ -94,11 +114,57 @@ bool FEditorActiveCameraStreamObject::IsValid() const
 	return true;
 }
 
-void FEditorActiveCameraStreamObject::Refresh(const TSharedPtr<ILiveLinkProvider> Provider)
+void FEditorActiveCameraStreamObject::NotifyRootInScene(bool bInScene)
+{
+	// Editor camera has no root model
+}
+
+bool FEditorActiveCameraStreamObject::CanUpdateInParallel() const
+{
+	// Looking up the active pane camera goes through the renderer, keep it on the evaluation thread
+	return false;
+}
+
+bool FEditorActiveCameraStreamObject::IsModelInHierarchy(const FBModel* Model) const
+{
+	// Only the camera currently shown in the viewport affects what we send
+	return Model != nullptr && Model == FBSystem().Scene->Renderer->GetCameraInPane(0);
+}
+
+void FEditorActiveCameraStreamObject::MarkDirty()
+{
+	bIsDirty = true;
+}
+
+bool FEditorActiveCameraStreamObject::IsDirty() const
+{
+	return bIsDirty;
+}
+
+bool FEditorActiveCameraStreamObject::ConsumeDirty()
+{
+	return bIsDirty.exchange(false);
+}
+
+void FEditorActiveCameraStreamObject::NotifyHierarchyEdit(const FBModel* Model, bool bDestroyed)
+{
+	// We stream a single camera and no hierarchy, only compare against the pane camera
+	if (IsModelInHierarchy(Model))
+	{
+		MarkDirty();
+	}
+}
+
+bool FEditorActiveCameraStreamObject::ApplyHierarchyEdits()
+{
+	return true;
+}
+
+bool FEditorActiveCameraStreamObject::Refresh(TSubclassOf<ULiveLinkRole>& OutRole, FLiveLinkStaticDataStruct& OutStaticData)
 {
 	if (!bIsActive)
 	{
-		return;
+		return false;
 	}
 
 	FBSystem System;
@@ -106,18 +172,21 @@ void FEditorActiveCameraStreamObject::Refresh(const TSharedPtr<ILiveLinkProvider
 
 	if (CameraModel)
 	{
-		FLiveLinkStaticDataStruct CameraData(FLiveLinkCameraStaticData::StaticStruct());
-		FModelStreamObject::UpdateSubjectTransformStaticData(CameraModel, bSendAnimatable, *CameraData.Cast<FLiveLinkCameraStaticData>());
-		FCameraStreamObject::UpdateSubjectCameraStaticData(CameraModel, *CameraData.Cast<FLiveLinkCameraStaticData>());
-		Provider->UpdateSubjectStaticData(SubjectName, ULiveLinkCameraRole::StaticClass(), MoveTemp(CameraData));
+		OutStaticData.InitializeWith(FLiveLinkCameraStaticData::StaticStruct(), nullptr);
+		CurveTableCamera = bSendAnimatable ? CameraModel : nullptr;
+		FModelStreamObject::UpdateSubjectTransformStaticData(CameraModel, bSendAnimatable ? &CurveTable : nullptr, *OutStaticData.Cast<FLiveLinkCameraStaticData>());
+		FCameraStreamObject::UpdateSubjectCameraStaticData(CameraModel, *OutStaticData.Cast<FLiveLinkCameraStaticData>());
+		OutRole = ULiveLinkCameraRole::StaticClass();
+		return true;
 	}
+	return false;
 }
 
-void FEditorActiveCameraStreamObject::UpdateSubjectFrame(const TSharedPtr<ILiveLinkProvider> Provider, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime)
+bool FEditorActiveCameraStreamObject::UpdateSubjectFrame(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkFrameDataStruct& OutFrameData)
 {
 	if (!bIsActive)
 	{
-		return;
+		return false;
 	}
 
 	FBSystem System;
@@ -125,9 +194,11 @@ void FEditorActiveCameraStreamObject::UpdateSubjectFrame(const TSharedPtr<ILiveL
 
 	if (CameraModel)
 	{
-		FLiveLinkFrameDataStruct CameraData(FLiveLinkCameraFrameData::StaticStruct());
-		FModelStreamObject::UpdateSubjectTransformFrameData(CameraModel, bSendAnimatable, WorldTime, QualifiedFrameTime, *CameraData.Cast<FLiveLinkTransformFrameData>());
-		FCameraStreamObject::UpdateSubjectCameraFrameData(CameraModel, *CameraData.Cast<FLiveLinkCameraFrameData>());
-		Provider->UpdateSubjectFrameData(SubjectName, MoveTemp(CameraData));
+		MobuUtilities::InitializeFrameData(OutFrameData, FLiveLinkCameraFrameData::StaticStruct());
+		const FMobuAnimatableCurveTable* StreamedCurveTable = (bSendAnimatable && CurveTableCamera == CameraModel) ? &CurveTable : nullptr;
+		FModelStreamObject::UpdateBaseFrameData(StreamedCurveTable, WorldTime, QualifiedFrameTime, EvaluateInfo, *OutFrameData.Cast<FLiveLinkCameraFrameData>());
+		FCameraStreamObject::UpdateSubjectCameraFrameData(CameraModel, EvaluateInfo, *OutFrameData.Cast<FLiveLinkCameraFrameData>());
+		return true;
 	}
+	return false;
 }
@@ -21,55 +21,54 @@ const FString FLightStreamObject::GetStreamOptions() const
 	return FString::Join(LightStreamOptions, _T("~"));
 };
 
-void FLightStreamObject::Refresh(const TSharedPtr<ILiveLinkProvider> Provider)
+bool FLightStreamObject::Refresh(TSubclassOf<ULiveLinkRole>& OutRole, FLiveLinkStaticDataStruct& OutStaticData)
 {
 	if (GetStreamingMode() == FLightStreamMode::RootOnly)
 	{
-		FLiveLinkStaticDataStruct TransformData(FLiveLinkTransformStaticData::StaticStruct());
-		UpdateSubjectTransformStaticData(RootModel, bSendAnimatable, *TransformData.Cast<FLiveLinkTransformStaticData>());
-		Provider->UpdateSubjectStaticData(SubjectName, ULiveLinkTransformRole::StaticClass(), MoveTemp(TransformData));
+		OutStaticData.InitializeWith(FLiveLinkTransformStaticData::StaticStruct(), nullptr);
+		UpdateSubjectTransformStaticData(RootModel, GetStreamedCurveTable(), *OutStaticData.Cast<FLiveLinkTransformStaticData>());
+		OutRole = ULiveLinkTransformRole::StaticClass();
 	}
 	else if (GetStreamingMode() == FLightStreamMode::FullHierarchy)
 	{
-		FLiveLinkStaticDataStruct SkeletonData(FLiveLinkSkeletonStaticData::StaticStruct());
-		UpdateSubjectSkeletalStaticData(*SkeletonData.Cast<FLiveLinkSkeletonStaticData>());
-		Provider->UpdateSubjectStaticData(SubjectName, ULiveLinkAnimationRole::StaticClass(), MoveTemp(SkeletonData));
+		OutStaticData.InitializeWith(FLiveLinkSkeletonStaticData::StaticStruct(), nullptr);
+		UpdateSubjectSkeletalStaticData(*OutStaticData.Cast<FLiveLinkSkeletonStaticData>());
+		OutRole = ULiveLinkAnimationRole::StaticClass();
 	}
 	else
 	{
-		FLiveLinkStaticDataStruct LightData(FLiveLinkLightStaticData::StaticStruct());
-		FModelStreamObject::UpdateSubjectTransformStaticData(RootModel, bSendAnimatable, *LightData.Cast<FLiveLinkLightStaticData>());
-		UpdateSubjectLightStaticData(static_cast<const FBLight*>(RootModel), *LightData.Cast<FLiveLinkLightStaticData>());
-		Provider->UpdateSubjectStaticData(SubjectName, ULiveLinkLightRole::StaticClass(), MoveTemp(LightData));
+		OutStaticData.InitializeWith(FLiveLinkLightStaticData::StaticStruct(), nullptr);
+		FModelStreamObject::UpdateSubjectTransformStaticData(RootModel, GetStreamedCurveTable(), *OutStaticData.Cast<FLiveLinkLightStaticData>());
+		UpdateSubjectLightStaticData(static_cast<const FBLight*>(RootModel), *OutStaticData.Cast<FLiveLinkLightStaticData>());
+		OutRole = ULiveLinkLightRole::StaticClass();
 	}
+	return true;
 };
 
-void FLightStreamObject::UpdateSubjectFrame(const TSharedPtr<ILiveLinkProvider> Provider, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime)
+bool FLightStreamObject::UpdateSubjectFrame(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkFrameDataStruct& OutFrameData)
 {
 	if (!bIsActive)
 	{
-		return;
+		return false;
 	}
 
 	if (GetStreamingMode() == FLightStreamMode::RootOnly)
 	{
-		FLiveLinkFrameDataStruct TransformData = (FLiveLinkTransformFrameData::StaticStruct());
-		UpdateSubjectTransformFrameData(RootModel, bSendAnimatable, WorldTime, QualifiedFrameTime, *TransformData.Cast<FLiveLinkTransformFrameData>());
-		Provider->UpdateSubjectFrameData(SubjectName, MoveTemp(TransformData));
+		MobuUtilities::InitializeFrameData(OutFrameData, FLiveLinkTransformFrameData::StaticStruct());
+		UpdateSubjectTransformFrameData(RootModel, GetStreamedCurveTable(), WorldTime, QualifiedFrameTime, EvaluateInfo, *OutFrameData.Cast<FLiveLinkTransformFrameData>());
 	}
 	else if (GetStreamingMode() == FLightStreamMode::FullHierarchy)
 	{
-		FLiveLinkFrameDataStruct TransformData = (FLiveLinkAnimationFrameData::StaticStruct());
-		UpdateSubjectSkeletalFrameData(WorldTime, QualifiedFrameTime, *TransformData.Cast<FLiveLinkAnimationFrameData>());
-		Provider->UpdateSubjectFrameData(SubjectName, MoveTemp(TransformData));
+		MobuUtilities::InitializeFrameData(OutFrameData, FLiveLinkAnimationFrameData::StaticStruct());
+		UpdateSubjectSkeletalFrameData(WorldTime, QualifiedFrameTime, EvaluateInfo, *OutFrameData.Cast<FLiveLinkAnimationFrameData>());
 	}
 	else
 	{
-		FLiveLinkFrameDataStruct LightData(FLiveLinkLightFrameData::StaticStruct());
-		FModelStreamObject::UpdateSubjectTransformFrameData(const_cast<FBModel*>(RootModel), bSendAnimatable, WorldTime, QualifiedFrameTime, *LightData.Cast<FLiveLinkTransformFrameData>());
-		UpdateSubjectLightFrameData(static_cast<const FBLight*>(RootModel), *LightData.Cast<FLiveLinkLightFrameData>());
-		Provider->UpdateSubjectFrameData(SubjectName, MoveTemp(LightData));
+		MobuUtilities::InitializeFrameData(OutFrameData, FLiveLinkLightFrameData::StaticStruct());
+		FModelStreamObject::UpdateSubjectTransformFrameData(RootModel, GetStreamedCurveTable(), WorldTime, QualifiedFrameTime, EvaluateInfo, *OutFrameData.Cast<FLiveLinkTransformFrameData>());
+		UpdateSubjectLightFrameData(static_cast<const FBLight*>(RootModel), EvaluateInfo, *OutFrameData.Cast<FLiveLinkLightFrameData>());
 	}
+	return true;
 }
 
 void FLightStreamObject::UpdateSubjectLightStaticData(const FBLight* LightModel, FLiveLinkLightStaticData& InOutLightFrame)
@@ -83,22 +82,25 @@ void FLightStreamObject::UpdateSubjectLightStaticData(const FBLight* LightModel,
 	InOutLightFrame.bIsOuterConeAngleSupported = (LightType == FBLightType::kFBLightTypeSpot);
 }
 
-void FLightStreamObject::UpdateSubjectLightFrameData(const FBLight* LightModel, FLiveLinkLightFrameData& InOutLightFrame)
+void FLightStreamObject::UpdateSubjectLightFrameData(const FBLight* LightModel, FBEvaluateInfo* EvaluateInfo, FLiveLinkLightFrameData& InOutLightFrame)
 {
 	double Intensity;
-	LightModel->Intensity.GetData(&Intensity, sizeof(Intensity), nullptr);
+	LightModel->Intensity.GetData(&Intensity, sizeof(Intensity), EvaluateInfo);
 
 	FBColor DiffuseColor;
-	LightModel->DiffuseColor.GetData(&DiffuseColor, sizeof(DiffuseColor), nullptr);
+	LightModel->DiffuseColor.GetData(&DiffuseColor, sizeof(DiffuseColor), EvaluateInfo);
 
 	InOutLightFrame.Intensity = Intensity;
 	InOutLightFrame.LightColor = MobuUtilities::MobuColorToUnreal(DiffuseColor);
 
 	FBLightType LightType;
-	LightModel->LightType.GetData(&LightType, sizeof(LightType), nullptr);
+	LightModel->LightType.GetData(&LightType, sizeof(LightType), EvaluateInfo);
 	if (LightType == FBLightType::kFBLightTypeSpot)
 	{
-		InOutLightFrame.InnerConeAngle = LightModel->InnerAngle;
-		InOutLightFrame.OuterConeAngle = LightModel->OuterAngle;
+		double InnerAngle, OuterAngle;
+		LightModel->InnerAngle.GetData(&InnerAngle, sizeof(InnerAngle), EvaluateInfo);
+		LightModel->OuterAngle.GetData(&OuterAngle, sizeof(OuterAngle), EvaluateInfo);
+		InOutLightFrame.InnerConeAngle = InnerAngle;
+		InOutLightFrame.OuterConeAngle = OuterAngle;
 	}
 }
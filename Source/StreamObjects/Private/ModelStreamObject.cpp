@@ -2,6 +2,8 @@
 
 #include "ModelStreamObject.h"
 #include "MobuLiveLinkUtilities.h"
+#include "MobuLiveLinkDrivenModels.h"
+#include "Misc/ScopeLock.h"
 #include <typeinfo>
 
 #include "Roles/LiveLinkAnimationRole.h"
@@ -12,6 +14,34 @@
 #include "Roles/LiveLinkTransformTypes.h"
 #include "UObject/ObjectPtr.h"
 
+//--- Parallel bone sampling
+THIRD_PARTY_INCLUDES_START
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace
+{
+	// Bones sampled by one task, enough to amortize scheduling and keep the conversion batches vectorized
+	const int32 ParallelBoneGrainSize = 64;
+
+	// Static bones are still sampled on one frame out of this many, catching what the classification cannot see.
+	// Until then a bone driven without a scene event streams its cached transform
+	const int32 StaticBoneCheckInterval = 30;
+
+	// An animation node exists as soon as the property is keyed on any layer of the take, even when the base layer has no curve.
+	// Anything connected into the property, expressions and property references included, writes it as well
+	bool IsPropertyDriven(FBPropertyAnimatable& Property)
+	{
+		return Property.IsAnimated() || Property.GetAnimationNode() != nullptr || Property.GetSrcCount() > 0;
+	}
+
+	bool IsTransformAnimated(FBModel* Model)
+	{
+		return IsPropertyDriven(Model->Translation) || IsPropertyDriven(Model->Rotation) || IsPropertyDriven(Model->Scaling);
+	}
+}
+
 // Creation / Destruction
 FModelStreamObject::FModelStreamObject(const FBModel* ModelPointer)
 	: RootModel(ModelPointer)
@@ -24,7 +54,7 @@ FModelStreamObject::FModelStreamObject(const FBModel* ModelPointer)
 	FString ModelLongName(ANSI_TO_TCHAR(RootModel->LongName));
 	FString RightString;
 	ModelLongName.Split(TEXT(":"), &ModelLongName, &RightString);
-	SubjectName = FName(*ModelLongName);
+	SubjectName.store(FName(*ModelLongName));
 };
 
 FModelStreamObject::~FModelStreamObject()
@@ -45,54 +75,70 @@ const FString FModelStreamObject::GetStreamOptions() const
 
 FName FModelStreamObject::GetSubjectName() const
 {
-	return SubjectName;
+	return SubjectName.load();
 };
 
 void FModelStreamObject::UpdateSubjectName(FName NewSubjectName)
 {
-	if (NewSubjectName != SubjectName)
-	{
-		SubjectName = NewSubjectName;
-	}
+	SubjectName.store(NewSubjectName);
 };
 
 
 int FModelStreamObject::GetStreamingMode() const
 {
-	return StreamingMode;
+	return StreamingMode.load();
 };
 
 void FModelStreamObject::UpdateStreamingMode(int NewStreamingMode)
 {
-	if (StreamingMode != NewStreamingMode)
-	{
-		StreamingMode = NewStreamingMode;
-	}
+	StreamingMode.store(NewStreamingMode);
 };
 
 bool FModelStreamObject::GetActiveStatus() const
 {
-	return bIsActive;
+	return bIsActive.load();
 };
 
 void FModelStreamObject::UpdateActiveStatus(bool bIsNowActive)
 {
-	bIsActive = bIsNowActive;
+	bIsActive.store(bIsNowActive);
 };
 
 bool FModelStreamObject::GetSendAnimatableStatus() const
 {
-	return bSendAnimatable;
+	return bSendAnimatable.load();
 };
 
 void FModelStreamObject::UpdateSendAnimatableStatus(bool bNewSendAnimatable)
 {
-	if (bSendAnimatable != bNewSendAnimatable)
-	{
-		bSendAnimatable = bNewSendAnimatable;
-	}
+	bSendAnimatable.store(bNewSendAnimatable);
+};
+
+FStreamRateClass FModelStreamObject::GetRateClass() const
+{
+	return RateClass.load();
+};
+
+void FModelStreamObject::UpdateRateClass(const FStreamRateClass& NewRateClass)
+{
+	FStreamRateClass ClampedRateClass;
+	ClampedRateClass.Divisor = FMath::Max(NewRateClass.Divisor, 1);
+	ClampedRateClass.MaxRate = FMath::Max(NewRateClass.MaxRate, 0);
+	RateClass.store(ClampedRateClass);
 };
 
+void FModelStreamObject::UpdateSkeletalSamplingSettings(const FSkeletalSamplingSettings& NewSettings)
+{
+	SkeletalSamplingMode.store(NewSettings.Mode, std::memory_order_relaxed);
+	ParallelBoneThreshold.store(NewSettings.ParallelBoneThreshold, std::memory_order_relaxed);
+	bCacheStaticBones.store(NewSettings.bCacheStaticBones, std::memory_order_relaxed);
+}
+
+void FModelStreamObject::UpdateDrivenModels(const FMobuDrivenModels* NewDrivenModels)
+{
+	DrivenModels = NewDrivenModels;
+}
+
 const FBModel* FModelStreamObject::GetModelPointer() const
 {
 	return RootModel;
@@ -106,235 +152,461 @@ const FString FModelStreamObject::GetRootName() const
 bool FModelStreamObject::IsValid() const
 {
 	// By Default an object is valid if the root model is in the scene
-	return FBSystem().Scene->Components.Find((FBComponent*)RootModel) >= 0;
+	return bIsRootInScene;
+};
+
+void FModelStreamObject::NotifyRootInScene(bool bInScene)
+{
+	bIsRootInScene = bInScene;
+};
+
+bool FModelStreamObject::CanUpdateInParallel() const
+{
+	// Models only read their own hierarchy, which is safe from a worker thread given an evaluate info
+	return true;
+};
+
+bool FModelStreamObject::IsModelInHierarchy(const FBModel* Model) const
+{
+	// The model belongs to us if walking up its parents reaches our root
+	for (FBModel* Ancestor = const_cast<FBModel*>(Model); Ancestor != nullptr; Ancestor = Ancestor->Parent)
+	{
+		if (Ancestor == RootModel)
+		{
+			return true;
+		}
+	}
+	return false;
+};
+
+void FModelStreamObject::MarkDirty()
+{
+	bIsDirty = true;
+};
+
+bool FModelStreamObject::IsDirty() const
+{
+	return bIsDirty;
+};
+
+bool FModelStreamObject::ConsumeDirty()
+{
+	bConsumedFullRefresh = bIsDirty.exchange(false);
+	return bConsumedFullRefresh || bHasHierarchyEdits;
+};
+
+void FModelStreamObject::NotifyHierarchyEdit(const FBModel* Model, bool bDestroyed)
+{
+	FScopeLock Lock(&HierarchyEditLock);
+	PendingHierarchyEdits.Add({ Model, bDestroyed });
+	bHasHierarchyEdits = true;
 };
 
-void FModelStreamObject::Refresh(const TSharedPtr<ILiveLinkProvider> Provider)
+bool FModelStreamObject::ApplyHierarchyEdits()
+{
+	{
+		FScopeLock Lock(&HierarchyEditLock);
+		Swap(PendingHierarchyEdits, AppliedHierarchyEdits);
+		bHasHierarchyEdits = false;
+	}
+
+	// A full refresh walks the scene again, the edits are already part of it
+	bool bHierarchyChanged = bConsumedFullRefresh;
+	if (!bHierarchyChanged)
+	{
+		bHierarchyChanged = Hierarchy.ApplyEdits(AppliedHierarchyEdits);
+	}
+	AppliedHierarchyEdits.Reset();
+	return bHierarchyChanged;
+};
+
+bool FModelStreamObject::Refresh(TSubclassOf<ULiveLinkRole>& OutRole, FLiveLinkStaticDataStruct& OutStaticData)
 {
 	if (GetStreamingMode() == FModelStreamMode::FullHierarchy)
 	{
-		FLiveLinkStaticDataStruct SkeletonData(FLiveLinkSkeletonStaticData::StaticStruct());
-		UpdateSubjectSkeletalStaticData(*SkeletonData.Cast<FLiveLinkSkeletonStaticData>());
-		Provider->UpdateSubjectStaticData(SubjectName, ULiveLinkAnimationRole::StaticClass(), MoveTemp(SkeletonData));
+		OutStaticData.InitializeWith(FLiveLinkSkeletonStaticData::StaticStruct(), nullptr);
+		UpdateSubjectSkeletalStaticData(*OutStaticData.Cast<FLiveLinkSkeletonStaticData>());
+		OutRole = ULiveLinkAnimationRole::StaticClass();
 	}
 	else if(GetStreamingMode() == FModelStreamMode::Locators)
 	{
-		FLiveLinkStaticDataStruct LocatorData(FLiveLinkLocatorStaticData::StaticStruct());
-		UpdateSubjectLocatorStaticData(*LocatorData.Cast<FLiveLinkLocatorStaticData>());
-		Provider->UpdateSubjectStaticData(SubjectName, ULiveLinkLocatorRole::StaticClass(), MoveTemp(LocatorData));
+		OutStaticData.InitializeWith(FLiveLinkLocatorStaticData::StaticStruct(), nullptr);
+		UpdateSubjectLocatorStaticData(*OutStaticData.Cast<FLiveLinkLocatorStaticData>());
+		OutRole = ULiveLinkLocatorRole::StaticClass();
 	}
 	else
 	{
-		FLiveLinkStaticDataStruct TransformData(FLiveLinkTransformStaticData::StaticStruct());
-		UpdateSubjectTransformStaticData(RootModel, bSendAnimatable, *TransformData.Cast<FLiveLinkTransformStaticData>());
-		Provider->UpdateSubjectStaticData(SubjectName, ULiveLinkTransformRole::StaticClass(), MoveTemp(TransformData));
+		OutStaticData.InitializeWith(FLiveLinkTransformStaticData::StaticStruct(), nullptr);
+		UpdateSubjectTransformStaticData(RootModel, GetStreamedCurveTable(), *OutStaticData.Cast<FLiveLinkTransformStaticData>());
+		OutRole = ULiveLinkTransformRole::StaticClass();
 	}
+	return true;
 }
 
-void FModelStreamObject::UpdateSubjectFrame(const TSharedPtr<ILiveLinkProvider> Provider, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime)
+bool FModelStreamObject::UpdateSubjectFrame(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkFrameDataStruct& OutFrameData)
 {
 	if (!bIsActive)
 	{
-		return;
+		return false;
 	}
 
 	if (GetStreamingMode() == FModelStreamMode::FullHierarchy)
 	{
-		FLiveLinkFrameDataStruct TransformData = (FLiveLinkAnimationFrameData::StaticStruct());
-		UpdateSubjectSkeletalFrameData(WorldTime, QualifiedFrameTime, *TransformData.Cast<FLiveLinkAnimationFrameData>());
-		Provider->UpdateSubjectFrameData(SubjectName, MoveTemp(TransformData));
+		MobuUtilities::InitializeFrameData(OutFrameData, FLiveLinkAnimationFrameData::StaticStruct());
+		UpdateSubjectSkeletalFrameData(WorldTime, QualifiedFrameTime, EvaluateInfo, *OutFrameData.Cast<FLiveLinkAnimationFrameData>());
 	}
 	else if(GetStreamingMode() == FModelStreamMode::Locators)
 	{
-		FLiveLinkFrameDataStruct LocatorData = (FLiveLinkLocatorFrameData::StaticStruct());
-		UpdateSubjectLocatorFrameData(WorldTime, QualifiedFrameTime, *LocatorData.Cast<FLiveLinkLocatorFrameData>());
-		Provider->UpdateSubjectFrameData(SubjectName, MoveTemp(LocatorData));
+		MobuUtilities::InitializeFrameData(OutFrameData, FLiveLinkLocatorFrameData::StaticStruct());
+		UpdateSubjectLocatorFrameData(WorldTime, QualifiedFrameTime, EvaluateInfo, *OutFrameData.Cast<FLiveLinkLocatorFrameData>());
 	}
 	else
 	{
-		FLiveLinkFrameDataStruct TransformData = (FLiveLinkTransformFrameData::StaticStruct());
-		UpdateSubjectTransformFrameData(RootModel, bSendAnimatable, WorldTime, QualifiedFrameTime, *TransformData.Cast<FLiveLinkTransformFrameData>());
-		Provider->UpdateSubjectFrameData(SubjectName, MoveTemp(TransformData));
+		MobuUtilities::InitializeFrameData(OutFrameData, FLiveLinkTransformFrameData::StaticStruct());
+		UpdateSubjectTransformFrameData(RootModel, GetStreamedCurveTable(), WorldTime, QualifiedFrameTime, EvaluateInfo, *OutFrameData.Cast<FLiveLinkTransformFrameData>());
 	}
+	return true;
 }
 
-void FModelStreamObject::UpdateBaseStaticData(const FBModel* Model, bool bSendAnimatable, FLiveLinkBaseStaticData& InOutBaseStaticData)
+void FModelStreamObject::UpdateBaseStaticData(const FBModel* Model, FMobuAnimatableCurveTable* CurveTable, FLiveLinkBaseStaticData& InOutBaseStaticData)
 {
-	if (bSendAnimatable)
+	if (CurveTable)
 	{
-		InOutBaseStaticData.PropertyNames = MobuUtilities::GetAllAnimatableCurveNames(const_cast<FBModel*>(Model), FString(ANSI_TO_TCHAR(Model->Name)));
+		// Static data is always rebuilt from the root, anything appended afterwards belongs to the same subject
+		CurveTable->Reset();
+		InOutBaseStaticData.PropertyNames.Reset();
+		CurveTable->AddModel(const_cast<FBModel*>(Model), FString(ANSI_TO_TCHAR(Model->Name)), InOutBaseStaticData.PropertyNames);
 	}
 }
 
-void FModelStreamObject::UpdateSubjectTransformStaticData(const FBModel* Model, bool bSendAnimatable, FLiveLinkTransformStaticData& InOutTransformStatic)
+void FModelStreamObject::UpdateSubjectTransformStaticData(const FBModel* Model, FMobuAnimatableCurveTable* CurveTable, FLiveLinkTransformStaticData& InOutTransformStatic)
 {
 	InOutTransformStatic.bIsScaleSupported = true;
-	UpdateBaseStaticData(Model, bSendAnimatable, InOutTransformStatic);
+	UpdateBaseStaticData(Model, CurveTable, InOutTransformStatic);
 }
 
 void FModelStreamObject::UpdateSubjectSkeletalStaticData(FLiveLinkSkeletonStaticData& InOutAnimationStatic)
 {
-	UpdateBaseStaticData(RootModel, bSendAnimatable, InOutAnimationStatic);
-
-	InOutAnimationStatic.BoneNames.Reset();
-	Parents.Reset();
-	Models.Reset();
-
-	InOutAnimationStatic.BoneNames.Emplace(RootModel->Name);
-	Parents.Emplace(-1);
-	Models.Emplace(RootModel);
+	UpdateBaseStaticData(RootModel, GetStreamedCurveTable(), InOutAnimationStatic);
 
-	GetHierarchy(InOutAnimationStatic.BoneNames, Parents, Models);
-	
-	InOutAnimationStatic.BoneParents = Parents;
+	Hierarchy.Update(RootModel, FMobuFlatHierarchy::EFilter::AllModels);
+	InOutAnimationStatic.BoneNames = Hierarchy.GetNames();
+	InOutAnimationStatic.BoneParents = Hierarchy.GetParents();
+	ClassifyStaticBones();
 
-	check(Models.Num() == InOutAnimationStatic.BoneNames.Num());
 	if (bSendAnimatable)
 	{
-		for (int32 Index = 0; Index < Models.Num(); ++Index)
-		{
-			InOutAnimationStatic.PropertyNames.Append(MobuUtilities::GetAllAnimatableCurveNames(const_cast<FBModel*>(Models[Index]), InOutAnimationStatic.BoneNames[Index].ToString()));
-		}
+		AddHierarchyToCurveTable(InOutAnimationStatic.PropertyNames);
 	}
 }
 
-void FModelStreamObject::UpdateBaseFrameData(const FBModel* Model, bool bSendAnimatable, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FLiveLinkBaseFrameData& InOutBaseFrameData)
+void FModelStreamObject::UpdateBaseFrameData(const FMobuAnimatableCurveTable* CurveTable, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkBaseFrameData& InOutBaseFrameData)
 {
 	InOutBaseFrameData.WorldTime = WorldTime;
 	InOutBaseFrameData.MetaData.SceneTime = QualifiedFrameTime;
-	if (bSendAnimatable)
+	if (CurveTable)
 	{
-		InOutBaseFrameData.PropertyValues = MobuUtilities::GetAllAnimatableCurveValues(const_cast<FBModel*>(Model));
+		// Values of the whole subject, in the order their names were added to the static data
+		CurveTable->Sample(EvaluateInfo, InOutBaseFrameData.PropertyValues);
 	}
+	else
+	{
+		// The frame may be reused from when animatables were still streamed
+		InOutBaseFrameData.PropertyValues.Reset();
+	}
+}
+
+void FModelStreamObject::UpdateSubjectTransformFrameData(const FBModel* Model, const FMobuAnimatableCurveTable* CurveTable, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkTransformFrameData& InOutTransformFrame)
+{
+	UpdateBaseFrameData(CurveTable, WorldTime, QualifiedFrameTime, EvaluateInfo, InOutTransformFrame);
+	InOutTransformFrame.Transform = MobuUtilities::UnrealTransformFromModel(const_cast<FBModel*>(Model), true, EvaluateInfo);
 }
 
-void FModelStreamObject::UpdateSubjectTransformFrameData(const FBModel* Model, bool bSendAnimatable, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FLiveLinkTransformFrameData& InOutTransformFrame)
+void FModelStreamObject::UpdateSubjectSkeletalFrameData(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkAnimationFrameData& InOutAnimationFrame)
 {
-	UpdateBaseFrameData(Model, bSendAnimatable, WorldTime, QualifiedFrameTime, InOutTransformFrame);
-	InOutTransformFrame.Transform = MobuUtilities::UnrealTransformFromModel(const_cast<FBModel*>(Model));
+	UpdateBaseFrameData(GetStreamedCurveTable(), WorldTime, QualifiedFrameTime, EvaluateInfo, InOutAnimationFrame);
+	UpdateSkeletalTransforms(EvaluateInfo, InOutAnimationFrame.Transforms);
 }
 
-void FModelStreamObject::UpdateSubjectSkeletalFrameData(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FLiveLinkAnimationFrameData& InOutAnimationFrame)
+void FModelStreamObject::AddHierarchyToCurveTable(TArray<FName>& OutPropertyNames)
 {
-	UpdateBaseFrameData(RootModel, bSendAnimatable, WorldTime, QualifiedFrameTime, InOutAnimationFrame);
+	const TArray<const FBModel*>& HierarchyModels = Hierarchy.GetModels();
+	const TArray<FName>& HierarchyNames = Hierarchy.GetNames();
+	for (int32 Index = 0; Index < HierarchyModels.Num(); ++Index)
+	{
+		CurveTable.AddModel(const_cast<FBModel*>(HierarchyModels[Index]), HierarchyNames[Index].ToString(), OutPropertyNames);
+	}
+}
 
-	if (Parents.Num() != Models.Num())
+void FModelStreamObject::UpdateSkeletalTransforms(FBEvaluateInfo* EvaluateInfo, TArray<FTransform>& OutTransforms)
+{
+	const TArray<const FBModel*>& BoneModels = Hierarchy.GetModels();
+	const TArray<int32>& BoneParents = Hierarchy.GetParents();
+	const TArray<bool>& BoneHasChildren = Hierarchy.GetHasChildren();
+
+	const int32 BoneCount = BoneModels.Num();
+	OutTransforms.SetNum(BoneCount, false);
+	BoneMatrices.SetNum(BoneCount, false);
+	ParentInverseTransforms.SetNum(BoneCount, false);
+	BoneIsValid.SetNum(BoneCount, false);
+	if (BoneCount == 0)
 	{
 		return;
 	}
 
-	const int32 BoneCount = Parents.Num();
-	InOutAnimationFrame.Transforms.SetNum(BoneCount);
+	// In local mode MotionBuilder already knows every local transform, only the root goes through global space
+	const ESkeletalSamplingMode SamplingMode = SkeletalSamplingMode.load(std::memory_order_relaxed);
+	const bool bLocal = SamplingMode == ESkeletalSamplingMode::SkeletalSampling_Local;
 
-	TArray<FTransform> ParentInverseTransforms;
-	ParentInverseTransforms.SetNum(BoneCount);
+	// A classification is only used for the hierarchy and the mode it was made for
+	const bool bHasStaticBones = StaticBones.Num() > 0 && BoneIsStatic.Num() == BoneCount && StaticBonesSamplingMode == SamplingMode;
+	const bool bCheckStaticBones = bHasStaticBones && --FramesUntilStaticBoneCheck <= 0;
+	const bool bSampleLiveBonesOnly = bHasStaticBones && !bCheckStaticBones;
 
-	// loop through children here
-	for (int BoneIndex = 0; BoneIndex < Models.Num(); ++BoneIndex)
+	// Positions index the sampled bones. They are the bone indices themselves unless only live bones are sampled,
+	// those are then converted into a compact scratch and scattered to their bones
+	const int32* SampledBones = bSampleLiveBonesOnly ? LiveBones.GetData() : nullptr;
+	const int32 SampleCount = bSampleLiveBonesOnly ? LiveBones.Num() : BoneCount;
+	if (bSampleLiveBonesOnly)
 	{
-		InOutAnimationFrame.Transforms[BoneIndex] = MobuUtilities::UnrealTransformFromModel(const_cast<FBModel*>(Models[BoneIndex]));
+		LiveBoneTransforms.SetNum(SampleCount, false);
+	}
+	FTransform* SampledTransforms = bSampleLiveBonesOnly ? LiveBoneTransforms.GetData() : OutTransforms.GetData();
 
-		// We seem to be getting NaNs from somewhere for some reason, so let's trap them here to prevent the engine from hitting the Ensure()
-		if (InOutAnimationFrame.Transforms[BoneIndex].ContainsNaN())
+	// Bones of a range are independent of each other and of any other range
+	auto SampleBones = [this, &BoneModels, &BoneHasChildren, EvaluateInfo, &OutTransforms, bLocal, SampledBones, SampledTransforms](int32 Begin, int32 End)
+	{
+		for (int32 Position = Begin; Position < End; ++Position)
 		{
-			FBTrace("ERROR - Subject %s contains NaNs - %s\n", TCHAR_TO_UTF8(*SubjectName.ToString()), TCHAR_TO_UTF8(*InOutAnimationFrame.Transforms[BoneIndex].ToString()));
-			ParentInverseTransforms[BoneIndex].SetIdentity();
-			InOutAnimationFrame.Transforms[BoneIndex].SetIdentity();
+			const int32 BoneIndex = SampledBones ? SampledBones[Position] : Position;
+			MobuUtilities::GetModelMatrix(const_cast<FBModel*>(BoneModels[BoneIndex]), BoneMatrices[Position], !bLocal || BoneIndex == 0, EvaluateInfo);
+		}
+
+		// The root is never static, it is always sampled first
+		if (bLocal)
+		{
+			int32 LocalBegin = Begin;
+			if (Begin == 0)
+			{
+				MobuUtilities::ConvertTransforms<MobuCoordinateSystem::FUnrealSpace>(BoneMatrices.GetData(), 1, SampledTransforms);
+				LocalBegin = 1;
+			}
+			MobuUtilities::ConvertTransforms<MobuCoordinateSystem::FUnrealLocalSpace>(BoneMatrices.GetData() + LocalBegin, End - LocalBegin, SampledTransforms + LocalBegin);
 		}
 		else
 		{
-			ParentInverseTransforms[BoneIndex] = InOutAnimationFrame.Transforms[BoneIndex].Inverse();
-			if (Parents[BoneIndex] != -1)
+			MobuUtilities::ConvertTransforms<MobuCoordinateSystem::FUnrealSpace>(BoneMatrices.GetData() + Begin, End - Begin, SampledTransforms + Begin);
+		}
+
+		for (int32 Position = Begin; Position < End; ++Position)
+		{
+			const int32 BoneIndex = SampledBones ? SampledBones[Position] : Position;
+			if (SampledBones)
+			{
+				OutTransforms[BoneIndex] = SampledTransforms[Position];
+			}
+
+			// We seem to be getting NaNs from somewhere for some reason, so let's trap them here to prevent the engine from hitting the Ensure()
+			BoneIsValid[BoneIndex] = !OutTransforms[BoneIndex].ContainsNaN();
+			if (!BoneIsValid[BoneIndex])
+			{
+				FBTrace("ERROR - Bone %s for Subject %s contains NaNs - %s\n", (const char*)BoneModels[BoneIndex]->Name, TCHAR_TO_UTF8(*GetSubjectName().ToString()), TCHAR_TO_UTF8(*OutTransforms[BoneIndex].ToString()));
+				ParentInverseTransforms[BoneIndex].SetIdentity();
+				OutTransforms[BoneIndex].SetIdentity();
+			}
+			else if (!bLocal && BoneHasChildren[BoneIndex])
+			{
+				ParentInverseTransforms[BoneIndex] = OutTransforms[BoneIndex].Inverse();
+			}
+		}
+	};
+
+	// Global mode only. Every parent inverse is known once sampling is done, so bones only read their parent's
+	auto ResolveBones = [this, &BoneParents, &OutTransforms, SampledBones](int32 Begin, int32 End)
+	{
+		for (int32 Position = Begin; Position < End; ++Position)
+		{
+			const int32 BoneIndex = SampledBones ? SampledBones[Position] : Position;
+			if (BoneIsValid[BoneIndex] && BoneParents[BoneIndex] != -1)
 			{
-				InOutAnimationFrame.Transforms[BoneIndex] = InOutAnimationFrame.Transforms[BoneIndex] * ParentInverseTransforms[Parents[BoneIndex]];
+				OutTransforms[BoneIndex] = OutTransforms[BoneIndex] * ParentInverseTransforms[BoneParents[BoneIndex]];
 			}
 		}
+	};
+
+	// Bones are only read concurrently through an evaluation context, the render callbacks read the shared scene state
+	const int32 ParallelThreshold = ParallelBoneThreshold.load(std::memory_order_relaxed);
+	if (ParallelThreshold > 0 && SampleCount >= ParallelThreshold)
+	{
+		const tbb::blocked_range<int32> Bones(0, SampleCount, ParallelBoneGrainSize);
+		if (EvaluateInfo != nullptr)
+		{
+			tbb::parallel_for(Bones, [&SampleBones](const tbb::blocked_range<int32>& Range)
+			{
+				SampleBones(Range.begin(), Range.end());
+			});
+		}
+		else
+		{
+			SampleBones(0, SampleCount);
+		}
+
+		if (!bLocal)
+		{
+			tbb::parallel_for(Bones, [&ResolveBones](const tbb::blocked_range<int32>& Range)
+			{
+				ResolveBones(Range.begin(), Range.end());
+			});
+		}
+	}
+	else
+	{
+		SampleBones(0, SampleCount);
+		if (!bLocal)
+		{
+			ResolveBones(0, SampleCount);
+		}
+	}
 
-		if (bSendAnimatable)
+	if (bSampleLiveBonesOnly)
+	{
+		for (int32 BoneIndex : StaticBones)
 		{
-			// Stream all parameters of all bones as "<BoneName>:<ParameterName>"
-			InOutAnimationFrame.PropertyValues.Append(MobuUtilities::GetAllAnimatableCurveValues(const_cast<FBModel*>(Models[BoneIndex])));
+			OutTransforms[BoneIndex] = StaticBoneTransforms[BoneIndex];
+			BoneIsValid[BoneIndex] = true;
 		}
 	}
+	else if (bHasStaticBones)
+	{
+		UpdateStaticBoneTransforms(OutTransforms);
+	}
 }
 
-void FModelStreamObject::UpdateSubjectLocatorStaticData(FLiveLinkLocatorStaticData& InOutLocatorFrame)
+void FModelStreamObject::ClassifyStaticBones()
 {
-	UpdateBaseStaticData(RootModel, bSendAnimatable, InOutLocatorFrame);
+	BoneIsStatic.Reset();
+	LiveBones.Reset();
+	StaticBones.Reset();
+	StaticBoneTransforms.Reset();
+	FramesUntilStaticBoneCheck = 0;
+	if (!bCacheStaticBones.load(std::memory_order_relaxed) || DrivenModels == nullptr)
+	{
+		return;
+	}
 
-	InOutLocatorFrame.LocatorNames.Reset();
-	Models.Reset();
-	
-	InOutLocatorFrame.LocatorNames.Emplace(RootModel->Name);
-	Models.Emplace(RootModel);
+	// Gathered by the device once for every subject, not walked from here
+	const TSharedRef<const FMobuDrivenModels::FModelSet, ESPMode::ThreadSafe> SceneDrivenModels = DrivenModels->Get();
 
-	GetHierarchy(InOutLocatorFrame.LocatorNames, Parents, Models);
-		
-	check(Models.Num() == InOutLocatorFrame.LocatorNames.Num());
-	if (bSendAnimatable)
+	// The root also moves with whatever it is parented to outside of the subject
+	const TArray<const FBModel*>& BoneModels = Hierarchy.GetModels();
+	BoneIsStatic.SetNumUninitialized(BoneModels.Num());
+	for (int32 BoneIndex = 0; BoneIndex < BoneModels.Num(); ++BoneIndex)
 	{
-		for (int32 Index = 0; Index < Models.Num(); ++Index)
-		{
-			InOutLocatorFrame.PropertyNames.Append(MobuUtilities::GetAllAnimatableCurveNames(const_cast<FBModel*>(Models[Index]), InOutLocatorFrame.LocatorNames[Index].ToString()));
-		}
-		InOutLocatorFrame.bUnlabelledData = false;
+		const FBModel* BoneModel = BoneModels[BoneIndex];
+		BoneIsStatic[BoneIndex] = BoneIndex != 0 && !SceneDrivenModels->Contains(BoneModel) && !IsTransformAnimated(const_cast<FBModel*>(BoneModel));
 	}
+
+	StaticBonesSamplingMode = SkeletalSamplingMode.load(std::memory_order_relaxed);
+	UpdateLiveBones();
 }
 
-void FModelStreamObject::UpdateSubjectLocatorFrameData(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FLiveLinkLocatorFrameData& InOutLocatorFrame)
+void FModelStreamObject::UpdateLiveBones()
 {
-	UpdateBaseFrameData(RootModel, bSendAnimatable, WorldTime, QualifiedFrameTime, InOutLocatorFrame);
+	const TArray<int32>& BoneParents = Hierarchy.GetParents();
+	const int32 BoneCount = BoneIsStatic.Num();
 
-	const int32 LocatorCount = Models.Num();
-	InOutLocatorFrame.Locators.SetNum(LocatorCount);
+	BoneIsSampled.SetNumUninitialized(BoneCount, false);
+	for (int32 BoneIndex = 0; BoneIndex < BoneCount; ++BoneIndex)
+	{
+		BoneIsSampled[BoneIndex] = !BoneIsStatic[BoneIndex];
+	}
 
-	//loop through children
-	for (int Index = 0; Index < Models.Num(); ++Index)
+	// Global mode makes a bone relative to its parent's sample, children come after their parent so one backward pass propagates
+	if (StaticBonesSamplingMode == ESkeletalSamplingMode::SkeletalSampling_Global)
 	{
-		InOutLocatorFrame.Locators[Index] = MobuUtilities::UnrealTransformFromModel(const_cast<FBModel*>(Models[Index])).GetLocation();
+		for (int32 BoneIndex = BoneCount - 1; BoneIndex > 0; --BoneIndex)
+		{
+			if (BoneIsSampled[BoneIndex])
+			{
+				BoneIsSampled[BoneParents[BoneIndex]] = true;
+			}
+		}
+	}
 
-		//If there are Nans handle it
+	// Sized for every bone, demoting bones moves them between the lists without growing either
+	LiveBones.Reset(BoneCount);
+	StaticBones.Reset(BoneCount);
+	for (int32 BoneIndex = 0; BoneIndex < BoneCount; ++BoneIndex)
+	{
+		(BoneIsSampled[BoneIndex] ? LiveBones : StaticBones).Add(BoneIndex);
+	}
+}
 
-		if(InOutLocatorFrame.Locators[Index].ContainsNaN())
+void FModelStreamObject::UpdateStaticBoneTransforms(const TArray<FTransform>& Transforms)
+{
+	if (StaticBoneTransforms.Num() != Transforms.Num())
+	{
+		StaticBoneTransforms.SetNumUninitialized(Transforms.Num());
+	}
+	else
+	{
+		// Keys added to a bone that was not animated, a constraint activated or a manual edit, nothing told us about those
+		bool bDemotedBones = false;
+		for (int32 BoneIndex : StaticBones)
 		{
-			InOutLocatorFrame.Locators[Index].ZeroVector;
+			if (!Transforms[BoneIndex].Equals(StaticBoneTransforms[BoneIndex]))
+			{
+				BoneIsStatic[BoneIndex] = false;
+				bDemotedBones = true;
+			}
 		}
-		
-		if (bSendAnimatable)
+
+		if (bDemotedBones)
 		{
-			InOutLocatorFrame.PropertyValues.Append(MobuUtilities::GetAllAnimatableCurveValues(const_cast<FBModel*>(Models[Index])));
+			UpdateLiveBones();
 		}
 	}
+
+	// Only the static bones are ever read back, the cache keeps its size from one check to the next
+	for (int32 BoneIndex : StaticBones)
+	{
+		StaticBoneTransforms[BoneIndex] = Transforms[BoneIndex];
+	}
+	FramesUntilStaticBoneCheck = StaticBoneCheckInterval;
+}
+
+void FModelStreamObject::UpdateSubjectLocatorStaticData(FLiveLinkLocatorStaticData& InOutLocatorFrame)
+{
+	UpdateBaseStaticData(RootModel, GetStreamedCurveTable(), InOutLocatorFrame);
+
+	Hierarchy.Update(RootModel, FMobuFlatHierarchy::EFilter::AllModels);
+	InOutLocatorFrame.LocatorNames = Hierarchy.GetNames();
+
+	if (bSendAnimatable)
+	{
+		AddHierarchyToCurveTable(InOutLocatorFrame.PropertyNames);
+		InOutLocatorFrame.bUnlabelledData = false;
+	}
 }
 
-void FModelStreamObject::GetHierarchy(TArray<FName>& ObjectNames, TArray<int32>& OutParents, TArray<const FBModel*>& OutModels)
+void FModelStreamObject::UpdateSubjectLocatorFrameData(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkLocatorFrameData& InOutLocatorFrame)
 {
+	UpdateBaseFrameData(GetStreamedCurveTable(), WorldTime, QualifiedFrameTime, EvaluateInfo, InOutLocatorFrame);
+
+	const TArray<const FBModel*>& LocatorModels = Hierarchy.GetModels();
+	const int32 LocatorCount = LocatorModels.Num();
+	InOutLocatorFrame.Locators.SetNum(LocatorCount, false);
+
+	//loop through children
+	for (int Index = 0; Index < LocatorCount; ++Index)
 	{
-		TArray<TPair<int, FBModel*>> SearchList;
-		TArray<TPair<int, FBModel*>> SearchListNext;
+		InOutLocatorFrame.Locators[Index] = MobuUtilities::UnrealTransformFromModel(const_cast<FBModel*>(LocatorModels[Index]), true, EvaluateInfo).GetLocation();
 
-		SearchList.Emplace(0, (FBModel*)RootModel);
+		//If there are Nans handle it
 
-		while (SearchList.Num() > 0)
+		if(InOutLocatorFrame.Locators[Index].ContainsNaN())
 		{
-			for (const TPair<int, FBModel*>& SearchPair : SearchList)
-			{
-				int ParentIndex = SearchPair.Key;
-				FBModel* SearchModel = SearchPair.Value;
-				int ChildCount = SearchModel->Children.GetCount();
-
-				for (int ChildIndex = 0; ChildIndex < ChildCount; ++ChildIndex)
-				{
-					FBModel* ChildModel = SearchModel->Children[ChildIndex];
-
-					ObjectNames.Emplace(ChildModel->Name);
-					OutParents.Emplace(ParentIndex);
-					OutModels.Emplace(ChildModel);
-					SearchListNext.Emplace(OutModels.Num() - 1, ChildModel);
-				}
-			}
-			SearchList = SearchListNext;
-			SearchListNext.Reset();
+			InOutLocatorFrame.Locators[Index].ZeroVector;
 		}
 	}
 }
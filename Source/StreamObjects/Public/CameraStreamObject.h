@@ -23,10 +23,10 @@ private:
 public:
 	FCameraStreamObject(const FBModel* ModelPointer);
 	virtual const FString GetStreamOptions() const override;
-	virtual void Refresh(const TSharedPtr<ILiveLinkProvider> Provider) override;
-	virtual void UpdateSubjectFrame(const TSharedPtr<ILiveLinkProvider> Provider, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime) override;
+	virtual bool Refresh(TSubclassOf<ULiveLinkRole>& OutRole, FLiveLinkStaticDataStruct& OutStaticData) override;
+	virtual bool UpdateSubjectFrame(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkFrameDataStruct& OutFrameData) override;
 
 public:
 	static void UpdateSubjectCameraStaticData(const FBCamera* CameraModel, FLiveLinkCameraStaticData& InOutCameraStatic);
-	static void UpdateSubjectCameraFrameData(const FBCamera* CameraModel, FLiveLinkCameraFrameData& InOutCameraFrame);
+	static void UpdateSubjectCameraFrameData(const FBCamera* CameraModel, FBEvaluateInfo* EvaluateInfo, FLiveLinkCameraFrameData& InOutCameraFrame);
 };
\ No newline at end of file
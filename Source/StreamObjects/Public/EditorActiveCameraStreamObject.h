@@ -3,6 +3,9 @@
 #pragma once
 
 #include "IStreamObject.h"
+#include "MobuLiveLinkUtilities.h"
+
+#include <atomic>
 
 // Wrapper for Streaming the Active Editor Camera 
 class FEditorActiveCameraStreamObject : public IStreamObject
@@ -29,18 +32,44 @@ public:
 	virtual bool GetSendAnimatableStatus() const final;
 	virtual void UpdateSendAnimatableStatus(bool bNewSendAnimatable) final;
 
+	FStreamRateClass GetRateClass() const final;
+	void UpdateRateClass(const FStreamRateClass& NewRateClass) final;
+
+	void UpdateSkeletalSamplingSettings(const FSkeletalSamplingSettings& NewSettings) final;
+	void UpdateDrivenModels(const FMobuDrivenModels* NewDrivenModels) final;
+
 	const FBModel* GetModelPointer() const final;
 
 	const FString GetRootName() const final;
 
 	bool IsValid() const final;
+	void NotifyRootInScene(bool bInScene) final;
+
+	bool CanUpdateInParallel() const final;
+
+	bool IsModelInHierarchy(const FBModel* Model) const final;
 
-	void Refresh(const TSharedPtr<ILiveLinkProvider> Provider) final;
-	void UpdateSubjectFrame(const TSharedPtr<ILiveLinkProvider> Provider, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime) final;
+	void MarkDirty() final;
+	bool IsDirty() const final;
+	bool ConsumeDirty() final;
+
+	void NotifyHierarchyEdit(const FBModel* Model, bool bDestroyed) final;
+	bool ApplyHierarchyEdits() final;
+
+	bool Refresh(TSubclassOf<ULiveLinkRole>& OutRole, FLiveLinkStaticDataStruct& OutStaticData) final;
+	bool UpdateSubjectFrame(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkFrameDataStruct& OutFrameData) final;
 
 private:
 
 	const FName SubjectName;
-	bool bIsActive;
-	bool bSendAnimatable;
+
+	// Set from the UI thread, read by whichever thread builds the frame
+	std::atomic<bool> bIsActive;
+	std::atomic<bool> bSendAnimatable;
+	std::atomic<FStreamRateClass> RateClass{ FStreamRateClass() };
+	std::atomic<bool> bIsDirty{ true };
+
+	// Only valid for the camera that was in the pane when the static data was built
+	FMobuAnimatableCurveTable CurveTable;
+	const FBModel* CurveTableCamera = nullptr;
 };
\ No newline at end of file
@@ -23,10 +23,10 @@ private:
 public:
 	FLightStreamObject(const FBModel* ModelPointer);
 	virtual const FString GetStreamOptions() const override;
-	virtual void Refresh(const TSharedPtr<ILiveLinkProvider> Provider) override;
-	virtual void UpdateSubjectFrame(const TSharedPtr<ILiveLinkProvider> Provider, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime) override;
+	virtual bool Refresh(TSubclassOf<ULiveLinkRole>& OutRole, FLiveLinkStaticDataStruct& OutStaticData) override;
+	virtual bool UpdateSubjectFrame(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkFrameDataStruct& OutFrameData) override;
 
 protected:
 	void UpdateSubjectLightStaticData(const FBLight* LightModel, FLiveLinkLightStaticData& InOutCameraFrame);
-	void UpdateSubjectLightFrameData(const FBLight* LightModel, FLiveLinkLightFrameData& InOutCameraFrame);
+	void UpdateSubjectLightFrameData(const FBLight* LightModel, FBEvaluateInfo* EvaluateInfo, FLiveLinkLightFrameData& InOutCameraFrame);
 };
\ No newline at end of file
@@ -3,6 +3,10 @@
 #pragma once
 
 #include "IStreamObject.h"
+#include "MobuLiveLinkUtilities.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
 
 struct FLiveLinkSkeletonStaticData;
 struct FLiveLinkAnimationFrameData;
@@ -50,37 +54,110 @@ public:
 	virtual bool GetSendAnimatableStatus() const override;
 	virtual void UpdateSendAnimatableStatus(bool bNewSendAnimatable) override;
 
+	virtual FStreamRateClass GetRateClass() const override;
+	virtual void UpdateRateClass(const FStreamRateClass& NewRateClass) override;
+
+	virtual void UpdateSkeletalSamplingSettings(const FSkeletalSamplingSettings& NewSettings) override;
+
+	virtual void UpdateDrivenModels(const FMobuDrivenModels* NewDrivenModels) override;
+
 	virtual const FBModel* GetModelPointer() const override;
 
 	virtual const FString GetRootName() const override;
 
 	virtual bool IsValid() const override;
+	virtual void NotifyRootInScene(bool bInScene) override;
+
+	virtual bool CanUpdateInParallel() const override;
 
-	virtual void Refresh(const TSharedPtr<ILiveLinkProvider> Provider) override;
-	virtual void UpdateSubjectFrame(const TSharedPtr<ILiveLinkProvider> Provider, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime) override;
+	virtual bool IsModelInHierarchy(const FBModel* Model) const override;
+
+	virtual void MarkDirty() override;
+	virtual bool IsDirty() const override;
+	virtual bool ConsumeDirty() override;
+
+	virtual void NotifyHierarchyEdit(const FBModel* Model, bool bDestroyed) override;
+	virtual bool ApplyHierarchyEdits() override;
+
+	virtual bool Refresh(TSubclassOf<ULiveLinkRole>& OutRole, FLiveLinkStaticDataStruct& OutStaticData) override;
+	virtual bool UpdateSubjectFrame(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkFrameDataStruct& OutFrameData) override;
 
 public:
-	static void UpdateBaseStaticData(const FBModel* Model, bool bSendAnimatable, FLiveLinkBaseStaticData& InOutBaseFrameData);
-	static void UpdateBaseFrameData(const FBModel* Model, bool bSendAnimatable, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FLiveLinkBaseFrameData& InOutBaseFrameData);
+	// A null CurveTable means animatable properties are not streamed
+	static void UpdateBaseStaticData(const FBModel* Model, FMobuAnimatableCurveTable* CurveTable, FLiveLinkBaseStaticData& InOutBaseFrameData);
+	static void UpdateBaseFrameData(const FMobuAnimatableCurveTable* CurveTable, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkBaseFrameData& InOutBaseFrameData);
 	void UpdateSubjectSkeletalStaticData(FLiveLinkSkeletonStaticData& InOutTransformFrame);
-	void UpdateSubjectSkeletalFrameData(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FLiveLinkAnimationFrameData& InOutTransformFrame);
-	static void UpdateSubjectTransformStaticData(const FBModel* Model, bool bSendAnimatable, FLiveLinkTransformStaticData& InOutTransformFrame);
-	static void UpdateSubjectTransformFrameData(const FBModel* Model, bool bSendAnimatable, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FLiveLinkTransformFrameData& InOutTransformFrame);
+	void UpdateSubjectSkeletalFrameData(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkAnimationFrameData& InOutTransformFrame);
+	static void UpdateSubjectTransformStaticData(const FBModel* Model, FMobuAnimatableCurveTable* CurveTable, FLiveLinkTransformStaticData& InOutTransformFrame);
+	static void UpdateSubjectTransformFrameData(const FBModel* Model, const FMobuAnimatableCurveTable* CurveTable, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkTransformFrameData& InOutTransformFrame);
 
 	void UpdateSubjectLocatorStaticData(FLiveLinkLocatorStaticData& InOutLocatorFrame);
-	void UpdateSubjectLocatorFrameData(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FLiveLinkLocatorFrameData& InOutLocatorFrame);
+	void UpdateSubjectLocatorFrameData(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkLocatorFrameData& InOutLocatorFrame);
 
 protected:
 	// Stream Variables
 	const FBModel* const RootModel;
 
-	FName SubjectName;
-	TArray<int32> Parents;
-	TArray<const FBModel*> Models;
-	bool bIsActive;
-	bool bSendAnimatable;
-	int StreamingMode;
-
-	// Get the names of the selected hierarchy and each object's parent ID
-	void GetHierarchy(TArray<FName>& ObjectNames, TArray<int32>& OutParents, TArray<const FBModel*>& OutModels);
+	// Set from the UI thread, read by whichever thread builds or sends the frame
+	std::atomic<FName> SubjectName;
+
+	// Models streamed under the root, shared by every hierarchical streaming mode
+	FMobuFlatHierarchy Hierarchy;
+
+	// Scratch space of the frame path, sized once per topology
+	TArray<FBMatrix> BoneMatrices;
+	TArray<FTransform> ParentInverseTransforms;
+	TArray<bool> BoneIsValid; //!< Bones whose sample was trapped as NaN are sent as identity
+
+	// Set from the UI thread, read by whichever thread builds the frame
+	std::atomic<bool> bIsActive;
+	std::atomic<bool> bSendAnimatable;
+	std::atomic<int> StreamingMode;
+	std::atomic<FStreamRateClass> RateClass{ FStreamRateClass() }; //!< Both limits are published together
+
+	// Animatable properties of every model we stream, rebuilt with the static data
+	FMobuAnimatableCurveTable CurveTable;
+
+	FMobuAnimatableCurveTable* GetStreamedCurveTable() { return bSendAnimatable ? &CurveTable : nullptr; }
+	const FMobuAnimatableCurveTable* GetStreamedCurveTable() const { return bSendAnimatable ? &CurveTable : nullptr; }
+
+	// Set from the UI thread, read by whichever thread builds the frame
+	std::atomic<ESkeletalSamplingMode> SkeletalSamplingMode{ ESkeletalSamplingMode::SkeletalSampling_Global };
+	std::atomic<int32> ParallelBoneThreshold{ FSkeletalSamplingSettings().ParallelBoneThreshold };
+	std::atomic<bool> bCacheStaticBones{ FSkeletalSamplingSettings().bCacheStaticBones };
+	const FMobuDrivenModels* DrivenModels = nullptr; //!< Set before the object is published to the evaluation
+
+	// Bones nothing can move, reused until a full resample every few frames demotes those that moved
+	TArray<bool> BoneIsStatic;
+	TArray<int32> LiveBones; //!< Bones sampled every frame, in hierarchy order so the root comes first
+	TArray<int32> StaticBones;
+	TArray<FTransform> StaticBoneTransforms; //!< Indexed by bone, empty until the first frame after a classification
+	TArray<FTransform> LiveBoneTransforms; //!< Scratch of the frame path, indexed like LiveBones
+	TArray<bool> BoneIsSampled; //!< Scratch of UpdateLiveBones, which also runs on the frame path when bones are demoted
+	ESkeletalSamplingMode StaticBonesSamplingMode = ESkeletalSamplingMode::SkeletalSampling_Global; //!< Global mode also samples the parents of live bones
+	int32 FramesUntilStaticBoneCheck = 0;
+
+	// New objects start dirty so their static data is sent before the first frame
+	std::atomic<bool> bIsDirty{ true };
+
+	// Scene edits recorded from the UI thread, they only need a resend if they touch the hierarchy we stream
+	TArray<FMobuFlatHierarchy::FEdit> PendingHierarchyEdits;
+	TArray<FMobuFlatHierarchy::FEdit> AppliedHierarchyEdits; //!< Swapped with the pending edits, keeps its allocation
+	FCriticalSection HierarchyEditLock;
+	std::atomic<bool> bHasHierarchyEdits{ false };
+	bool bConsumedFullRefresh = false; //!< Whether the last ConsumeDirty() took a MarkDirty() and not only edits
+
+	// Objects are created from models found in the scene, the device keeps this up to date from there
+	std::atomic<bool> bIsRootInScene{ true };
+
+	// Append the animatable properties of every model of the hierarchy, in hierarchy order
+	void AddHierarchyToCurveTable(TArray<FName>& OutPropertyNames);
+
+	// Shared by every skeletal subject, large hierarchies are sampled on several threads
+	void UpdateSkeletalTransforms(FBEvaluateInfo* EvaluateInfo, TArray<FTransform>& OutTransforms);
+
+	// Called once the hierarchy of a skeletal subject is up to date
+	void ClassifyStaticBones();
+	void UpdateLiveBones();
+	void UpdateStaticBoneTransforms(const TArray<FTransform>& Transforms);
 };
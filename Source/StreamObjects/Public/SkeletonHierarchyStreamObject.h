@@ -26,14 +26,9 @@ public:
 	virtual const FString GetStreamOptions() const override;
 
 	// Override Refresh to only add Skeletal Children to the stream Hierarchy
-	virtual void Refresh(const TSharedPtr<ILiveLinkProvider> Provider) override;
-	virtual void UpdateSubjectFrame(const TSharedPtr<ILiveLinkProvider> Provider, FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime) override;
+	virtual bool Refresh(TSubclassOf<ULiveLinkRole>& OutRole, FLiveLinkStaticDataStruct& OutStaticData) override;
+	virtual bool UpdateSubjectFrame(FLiveLinkWorldTime WorldTime, FQualifiedFrameTime QualifiedFrameTime, FBEvaluateInfo* EvaluateInfo, FLiveLinkFrameDataStruct& OutFrameData) override;
 
 	void UpdateSubjectStaticData(FLiveLinkSkeletonStaticData& InOutAnimationFrame);
-	void UpdateSubjectFrameData(FLiveLinkAnimationFrameData& InOutAnimationFrame);
-
-private:
-	TArray<FName> BoneNames;
-	TArray<int32> BoneParents;
-	TArray<const FBModel*> BoneModels;
+	void UpdateSubjectFrameData(FBEvaluateInfo* EvaluateInfo, FLiveLinkAnimationFrameData& InOutAnimationFrame);
 };
\ No newline at end of file